@@ -170,6 +170,15 @@ void autoiso_disable() {
 	}
 }
 
+/**
+ * @brief Observer for changes of Tv: restore ISO when going into bulb
+ * @ingroup autoiso
+ */
+void autoiso_tv_changed(int value) {
+	if (settings.autoiso_enable)
+		enqueue_action(autoiso_restore);
+}
+
 /**
  * @brief Restore the minimal ISO if in mode M and Bulb is selected as Tv.
  * @ingroup autoiso
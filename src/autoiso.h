@@ -7,4 +7,6 @@ extern void autoiso_enable (void);
 extern void autoiso_disable(void);
 extern void autoiso_restore(void);
 
+extern void autoiso_tv_changed(int value);
+
 #endif
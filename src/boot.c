@@ -0,0 +1,88 @@
+/**
+ * \file boot.c
+ * \brief Boot-phase profiler
+ *
+ * Each phase of our initialization, as listed in boot.def, records when it
+ * started and ended, relative to the first phase, into a static buffer; the
+ * result is shown in the Info menu and written to the log once start-up has
+ * completed. The code that runs before the original firmware starts
+ * (hack_relocate and cache_hacks) cannot be timed, as there is no clock yet.
+ */
+
+#include <vxworks.h>
+#include <stdio.h>
+
+#include "firmware.h"
+
+#include "main.h"
+#include "macros.h"
+
+#include "utils.h"
+
+#include "boot.h"
+
+#define BOOT_PHASE_DEF(name, label) label,
+static const char *boot_labels[BOOT_PHASE_COUNT] = {
+	#include "boot.def"
+};
+#undef BOOT_PHASE_DEF
+
+static boot_marker_t boot_markers[BOOT_PHASE_COUNT] = {
+	[0 ... BOOT_PHASE_COUNT - 1] = {start : -1, end : -1},
+};
+
+static int boot_base = -1;
+
+static int boot_time(void);
+
+/**
+ * @brief Mark the start of a boot phase
+ */
+void boot_begin(boot_phase_t phase) {
+	boot_markers[phase].start = boot_time();
+}
+
+/**
+ * @brief Mark the end of a boot phase
+ */
+void boot_end(boot_phase_t phase) {
+	boot_markers[phase].end = boot_time();
+}
+
+/**
+ * @brief Print "start +duration" for a phase, in ms
+ */
+void boot_summary(char *buffer, boot_phase_t phase) {
+	const boot_marker_t *marker = &boot_markers[phase];
+
+	if (marker->start < 0)
+		sprintf(buffer, "-");
+	else if (marker->end < marker->start)
+		sprintf(buffer, "%d +?", marker->start);
+	else
+		sprintf(buffer, "%d +%d", marker->start, marker->end - marker->start);
+}
+
+/**
+ * @brief Write all boot phases to the log
+ *
+ * Enqueued as the last action of the start-up, so every phase has ended.
+ */
+void boot_report() {
+	int  phase;
+	char buffer[32];
+
+	for (phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+		boot_summary(buffer, phase);
+		printf_log(8, 8, "[420D] boot %s: %s ms", boot_labels[phase], buffer);
+	}
+}
+
+static int boot_time() {
+	int now = timestamp();
+
+	if (boot_base < 0)
+		boot_base = now;
+
+	return now - boot_base;
+}
@@ -0,0 +1,28 @@
+#ifndef BOOT_H_
+#define BOOT_H_
+
+/**
+ * \file boot.h
+ * \brief Header for boot.c
+ */
+
+#define BOOT_PHASE_DEF(name, label) name,
+typedef enum {
+	#include "boot.def"
+	BOOT_PHASE_COUNT,
+	BOOT_PHASE_FIRST = 0,
+	BOOT_PHASE_LAST  = BOOT_PHASE_COUNT - 1
+} boot_phase_t;
+#undef BOOT_PHASE_DEF
+
+typedef struct {
+	int start; // Milliseconds since the first phase started, or -1 if it did not run
+	int end;
+} boot_marker_t;
+
+extern void boot_begin  (boot_phase_t phase);
+extern void boot_end    (boot_phase_t phase);
+extern void boot_summary(char *buffer, boot_phase_t phase);
+extern void boot_report (void);
+
+#endif /* BOOT_H_ */
@@ -0,0 +1,202 @@
+/**
+ * \file checkpoint.c
+ * \brief Checkpoints of long scripts, to resume them after a power cycle
+ *
+ * Checkpoints are written alternately to one of two slots of a small file,
+ * so a write interrupted by a power loss can only spoil one of them; each
+ * slot carries a CRC, and the valid one with the highest sequence is used.
+ * The file is removed when the script ends normally, so a checkpoint found
+ * at start-up means that a script was interrupted. As with the frame log,
+ * a checkpoint is only kept in memory after a release, and written during
+ * the next pause long enough, so writing it never delays a shot.
+ */
+
+#include <vxworks.h>
+#include <ioLib.h>
+
+#include "firmware.h"
+#include "firmware/fio.h"
+
+#include "main.h"
+#include "macros.h"
+
+#include "perf.h"
+#include "utils.h"
+
+#include "checkpoint.h"
+
+static int          checkpoint_sequence = 0;
+static int          checkpoint_hold     = FALSE; // Camera is shutting down, keep the checkpoint
+static int          checkpoint_valid    = FALSE; // A checkpoint was found at start-up
+static checkpoint_t checkpoint_found;
+static int          checkpoint_waiting  = FALSE; // A checkpoint is waiting to be written
+static checkpoint_t checkpoint_buffer;
+
+static void         checkpoint_write(void);
+static unsigned int checkpoint_crc  (const checkpoint_t *checkpoint);
+
+/**
+ * @brief Start taking checkpoints for a new script
+ *
+ * Any previous checkpoint is dropped, as sequences start again.
+ */
+void checkpoint_start() {
+	FIO_RemoveFile(MKPATH_NEW(CHECKPOINT_FILENAME));
+
+	checkpoint_sequence = 0;
+	checkpoint_hold     = FALSE;
+	checkpoint_valid    = FALSE;
+	checkpoint_waiting  = FALSE;
+}
+
+/**
+ * @brief Keep a checkpoint, to be written to the next slot in a pause
+ *
+ * Call right after a release; the checkpoint is written by checkpoint_idle,
+ * or when the script stops.
+ */
+void checkpoint_save(checkpoint_t *checkpoint) {
+	checkpoint->magic    = CHECKPOINT_MAGIC;
+	checkpoint->sequence = ++checkpoint_sequence;
+	checkpoint->crc      = checkpoint_crc(checkpoint);
+
+	checkpoint_buffer  = *checkpoint;
+	checkpoint_waiting = TRUE;
+}
+
+/**
+ * @brief Write the last checkpoint, if the script is about to wait long enough
+ *
+ * Called at the start of every pause of a script.
+ *
+ * @param delay Length of the pause, in ms
+ */
+void checkpoint_idle(int delay) {
+	if (checkpoint_waiting && delay >= CHECKPOINT_IDLE_MIN)
+		checkpoint_write();
+}
+
+/**
+ * @brief Forget the checkpoints, as the script ended normally
+ *
+ * When they are kept instead, the last one is written now.
+ */
+void checkpoint_clear() {
+	if (checkpoint_hold && checkpoint_waiting)
+		checkpoint_write();
+
+	if (!checkpoint_hold && checkpoint_sequence > 0)
+		FIO_RemoveFile(MKPATH_NEW(CHECKPOINT_FILENAME));
+
+	checkpoint_sequence = 0;
+	checkpoint_waiting  = FALSE;
+}
+
+/**
+ * @brief Keep the checkpoints even if the script stops (camera shutting down, or battery critical)
+ */
+void checkpoint_shutdown() {
+	checkpoint_hold = TRUE;
+}
+
+/**
+ * @brief Look for a checkpoint left by an interrupted script
+ */
+void checkpoint_init() {
+	int file, slot;
+	checkpoint_t checkpoint;
+
+	checkpoint_valid = FALSE;
+
+	if ((file = FIO_OpenFile(MKPATH_NEW(CHECKPOINT_FILENAME), O_RDONLY)) == -1)
+		return;
+
+	for (slot = 0; slot < CHECKPOINT_SLOTS; slot++) {
+		if (FIO_ReadFile(file, &checkpoint, sizeof(checkpoint)) != sizeof(checkpoint))
+			break;
+
+		if (checkpoint.magic != CHECKPOINT_MAGIC || checkpoint.crc != checkpoint_crc(&checkpoint))
+			continue;
+
+		if (!checkpoint_valid || checkpoint.sequence > checkpoint_found.sequence) {
+			checkpoint_found = checkpoint;
+			checkpoint_valid = TRUE;
+		}
+	}
+
+	FIO_CloseFile(file);
+
+	// Let the user know there is a script to resume
+	if (checkpoint_valid) {
+		beep();
+		SleepTask(BEEP_LED_LENGTH);
+		beep();
+	}
+}
+
+/**
+ * @return TRUE if an interrupted script can be resumed
+ */
+int checkpoint_pending() {
+	return checkpoint_valid;
+}
+
+/**
+ * @brief Get the checkpoint to resume from; it can only be taken once
+ *
+ * The file is kept, and new checkpoints follow its sequence, so it still
+ * holds a valid checkpoint if the resumed script is interrupted again
+ * before writing one of its own; do not call checkpoint_start afterwards.
+ *
+ * @return TRUE if there was a checkpoint
+ */
+int checkpoint_take(checkpoint_t *checkpoint) {
+	if (!checkpoint_valid)
+		return FALSE;
+
+	*checkpoint      = checkpoint_found;
+	checkpoint_valid = FALSE;
+
+	checkpoint_sequence = checkpoint_found.sequence;
+	checkpoint_hold     = FALSE;
+	checkpoint_waiting  = FALSE;
+
+	return TRUE;
+}
+
+/**
+ * @brief Write the checkpoint waiting in memory to its slot
+ *
+ * The file is closed after each write, so it is always consistent on the card.
+ */
+static void checkpoint_write() {
+	int file, start = timestamp();
+
+	checkpoint_waiting = FALSE;
+
+	if ((file = FIO_OpenFile(MKPATH_NEW(CHECKPOINT_FILENAME), O_CREAT | O_WRONLY)) == -1)
+		return;
+
+	FIO_SeekFile (file, (checkpoint_buffer.sequence % CHECKPOINT_SLOTS) * sizeof(checkpoint_t), 0/*SEEK_SET*/);
+	FIO_WriteFile(file, &checkpoint_buffer, sizeof(checkpoint_t));
+	FIO_CloseFile(file);
+
+	perf_file(PERF_FILE_WRITE, timestamp() - start);
+}
+
+static unsigned int checkpoint_crc(const checkpoint_t *checkpoint) {
+	int i, bit;
+	unsigned int crc = 0xFFFFFFFF;
+
+	const unsigned char *data = (const unsigned char *)checkpoint;
+
+	// The CRC is the last field, and is not included
+	for (i = 0; i < sizeof(checkpoint_t) - sizeof(checkpoint->crc); i++) {
+		crc ^= data[i];
+
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+	}
+
+	return ~crc;
+}
@@ -0,0 +1,38 @@
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+/**
+ * \file checkpoint.h
+ * \brief Header for checkpoint.c
+ */
+
+#define CHECKPOINT_FILENAME "RESUME.BIN"
+#define CHECKPOINT_MAGIC    0x454D5352 // "RSME"
+#define CHECKPOINT_SLOTS    2
+
+#define CHECKPOINT_FRAMES    10 // Frames between checkpoints
+#define CHECKPOINT_IDLE_MIN 500 // Shortest pause to write a checkpoint in, in ms
+
+typedef struct {
+	int          magic;
+	int          sequence;  // Incremented with every checkpoint, the highest valid one wins
+	int          script;    // Script running, one of script_t
+	int          shot;      // Next shot to take
+	int          next_time; // Wall-clock time of the next shot (seconds, as in time())
+	int          elapsed;   // Time since the script started (ms)
+	int          expo;      // Bulb ramping: current exposure (ms)
+	int          filtered;  // Bulb ramping: filtered deviation (1/1000 EV)
+	unsigned int crc;       // CRC-32 of all fields above
+} checkpoint_t;
+
+extern void checkpoint_start   (void);
+extern void checkpoint_save    (checkpoint_t *checkpoint);
+extern void checkpoint_idle    (int delay);
+extern void checkpoint_clear   (void);
+extern void checkpoint_shutdown(void);
+
+extern void checkpoint_init    (void);
+extern int  checkpoint_pending (void);
+extern int  checkpoint_take    (checkpoint_t *checkpoint);
+
+#endif /* CHECKPOINT_H_ */
@@ -11,6 +11,7 @@
 #include "firmware/gui.h"
 #include "firmware/eventproc.h"
 
+#include "property.h"
 #include "settings.h"
 
 #include "debug.h"
@@ -365,6 +366,9 @@ void print_info() {
 	// print current DP settings to the log
 	eventproc_RiseEvent("PrintDPStatus");
 
+	// print how long the camera takes to apply our properties
+	property_print_stats();
+
 	beep();
 	debug_log("Info dumped.\n");
 }
@@ -96,3 +96,23 @@ void fexp_update_tv(void) {
 		send_to_intercom(IC_SET_TV_VAL, tv);
 	}
 }
+
+/**
+ * @brief Observer for changes of Tv: keep the exposure by changing Av.
+ * @ingroup fexp
+ *
+ */
+void fexp_tv_changed(int value) {
+	if (status.vf_status == VF_STATUS_FEXP)
+		enqueue_action(fexp_update_av);
+}
+
+/**
+ * @brief Observer for changes of Av: keep the exposure by changing Tv.
+ * @ingroup fexp
+ *
+ */
+void fexp_av_changed(int value) {
+	if (status.vf_status == VF_STATUS_FEXP)
+		enqueue_action(fexp_update_tv);
+}
@@ -13,4 +13,7 @@ extern void fexp_disable  (void);
 extern void fexp_update_av(void);
 extern void fexp_update_tv(void);
 
+extern void fexp_tv_changed(int value);
+extern void fexp_av_changed(int value);
+
 #endif
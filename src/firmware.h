@@ -6,6 +6,7 @@
 #define FIRMWARE_H_
 
 #include <vxworks.h>
+#include <semLib.h>
 
 // Variables, Flags, Pointers, Handlers
 #define BTN_PRESSED     0x20
@@ -227,13 +228,14 @@ extern int SendToIntercom(int message, int length, int parm);
 extern int IntercomHandlerButton(int button, int unknown);
 
 // Semaphores
-/*
+
 extern SEM_ID CreateBinarySemaphore(char * name, SEM_B_STATE state); // SEM_EMPTY (0), SEM_FULL (1)
-extern int TakeSemaphore(SEM_ID sem, int time);
+extern int TakeSemaphore(SEM_ID sem, int time); // Returns 0 if taken, time in ms
+extern int TryTakeSemaphore(SEM_ID sem);
 extern int GiveSemaphore(SEM_ID sem);
 extern int DeleteSemaphore(int* sem);
 extern SEM_ID hMainCtrlMonoSem;
-*/
+
 // Display
 
 extern char *sub_FF83A640(void); // cf free space - reports wrong ?
@@ -3,6 +3,7 @@
  * @brief Management of intercom?
  */
 #include <vxworks.h>
+#include <intLib.h>
 
 #include "firmware.h"
 #include "firmware/gui.h"
@@ -14,6 +15,7 @@
 #include "autoiso.h"
 #include "af_patterns.h"
 #include "button.h"
+#include "checkpoint.h"
 #include "cmodes.h"
 #include "fexp.h"
 #include "qexp.h"
@@ -23,15 +25,25 @@
 #include "menu_rename.h"
 #include "msm.h"
 #include "persist.h"
+#include "property.h"
 #include "shortcuts.h"
+#include "trace.h"
 #include "viewfinder.h"
 #include "debug.h"
+#include "recorder.h"
+#include "perf.h"
+#include "utils.h"
 
 #include "intercom.h"
 
 // Proxy listeners
 int proxy_script_restore (char *message);
 int proxy_script_stop    (char *message);
+int proxy_script_finish  (char *message);
+int proxy_script_measure (char *message);
+int proxy_script_battery (char *message);
+int proxy_script_temp    (char *message);
+int proxy_temperature    (char *message);
 int proxy_set_language   (char *message);
 int proxy_dialog_enter   (char *message);
 int proxy_dialog_exit    (char *message);
@@ -45,126 +57,303 @@ int proxy_settings3      (char *message);
 int proxy_button         (char *message);
 int proxy_wheel          (char *message);
 int proxy_initialize     (char *message);
-int proxy_tv             (char *message);
-int proxy_av             (char *message);
-int proxy_aeb            (char *message);
 
 typedef int (*proxy_t) (char*);
 
-proxy_t listeners_script[0x100] = {
-	[IC_SHUTDOWN]    = proxy_script_restore,
-	[IC_SHOOT_START] = proxy_shoot_start,
-	[IC_BUTTON_DP]   = proxy_script_stop,
+/**
+ * @brief Listener for one intercom message
+ *
+ * Listener tables are kept sorted by message, so they can be searched by
+ * bisection; keep this in mind when adding new entries.
+ */
+typedef struct {
+	ic_event_t message;
+	proxy_t    proxy;
+} listener_t;
+
+typedef struct {
+	int               size;
+	const listener_t *data;
+} listeners_t;
+
+static const listener_t script_listeners[] = {
+	{IC_SHUTDOWN,     proxy_script_restore},
+	{IC_BAT_TYPE,     proxy_script_battery},
+	{IC_BC_LEVEL,     proxy_script_battery},
+	{IC_TEMP,         proxy_script_temp},
+	{IC_MEASUREMENT,  proxy_script_measure},
+	{IC_SHOOT_START,  proxy_shoot_start},
+	{IC_SHOOT_FINISH, proxy_script_finish},
+	{IC_BUTTON_DP,    proxy_script_stop},
 };
 
-proxy_t listeners_menu[0x100] = {
-	[IC_DIALOGOFF]     = proxy_dialog_exit,
-	[IC_BUTTON_WHEEL]  = proxy_wheel,
-	[IC_BUTTON_DISP]   = proxy_button,
-	[IC_BUTTON_SET]    = proxy_button,
-	[IC_BUTTON_RIGHT]  = proxy_button,
-	[IC_BUTTON_LEFT]   = proxy_button,
-	[IC_BUTTON_DP]     = proxy_button,
-	[IC_BUTTON_AV]     = proxy_button,
+static const listener_t menu_listeners[] = {
+	{IC_DIALOGOFF,    proxy_dialog_exit},
+	{IC_TEMP,         proxy_temperature},
+	{IC_BUTTON_DISP,  proxy_button},
+	{IC_BUTTON_SET,   proxy_button},
+	{IC_BUTTON_WHEEL, proxy_wheel},
+	{IC_BUTTON_RIGHT, proxy_button},
+	{IC_BUTTON_LEFT,  proxy_button},
+	{IC_BUTTON_DP,    proxy_button},
+	{IC_BUTTON_AV,    proxy_button},
 };
 
 /**
  * @brief Listeners for all Intercom messages.
  *
  */
-proxy_t listeners_main[0x100] = {
-	[IC_SET_TV_VAL]    = proxy_tv,
-	[IC_SET_AV_VAL]    = proxy_av,
-	[IC_SET_AE_BKT]    = proxy_aeb,
-	[IC_SET_LANGUAGE]  = proxy_set_language,
-	[IC_DIALOGON]      = proxy_dialog_enter,
-	[IC_MEASURING]     = proxy_measuring,
-	[IC_MEASUREMENT]   = proxy_measurement,
-	[IC_SHOOT_FINISH]  = proxy_shoot_finish,
-	[IC_UNKNOWN_8D]    = proxy_initialize,
-	[IC_SETTINGS_0]    = proxy_settings0,
-	[IC_SETTINGS_3]    = proxy_settings3,
-	[IC_AFPDLGOFF]     = proxy_dialog_afoff,
-	[IC_BUTTON_WHEEL]  = proxy_wheel,
-	[IC_BUTTON_DISP]   = proxy_button,
-	[IC_BUTTON_SET]    = proxy_button,
-	[IC_BUTTON_UP]     = proxy_button,
-	[IC_BUTTON_DOWN]   = proxy_button,
-	[IC_BUTTON_RIGHT]  = proxy_button,
-	[IC_BUTTON_LEFT]   = proxy_button,
-	[IC_BUTTON_DP]     = proxy_button,
-	[IC_BUTTON_AV]     = proxy_button,
+static const listener_t main_listeners[] = {
+	{IC_SET_AE,                 property_notify},
+	{IC_SET_METERING,           property_notify},
+	{IC_SET_EFCOMP,             property_notify},
+	{IC_SET_DRIVE,              property_notify},
+	{IC_SET_WB,                 property_notify},
+	{IC_SET_AF_POINT,           property_notify},
+	{IC_SET_TV_VAL,             property_notify},
+	{IC_SET_AV_VAL,             property_notify},
+	{IC_SET_AV_COMP,            property_notify},
+	{IC_SET_ISO,                property_notify},
+	{IC_SET_AE_BKT,             property_notify},
+	{IC_SET_LANGUAGE,           proxy_set_language},
+	{IC_SET_IMG_FORMAT,         property_notify},
+	{IC_SET_IMG_SIZE,           property_notify},
+	{IC_SET_IMG_QUALITY,        property_notify},
+	{IC_SET_CF_EMIT_AUX,        property_notify},
+	{IC_SET_CF_EMIT_FLASH,      property_notify},
+	{IC_SET_CF_AEB_SEQUENCE,    property_notify},
+	{IC_SET_CF_MIRROR_UP_LOCK,  property_notify},
+	{IC_SET_CF_FLASH_SYNC_REAR, property_notify},
+	{IC_SET_CF_SAFETY_SHIFT,    property_notify},
+	{IC_DIALOGON,               proxy_dialog_enter},
+	{IC_TEMP,                   proxy_temperature},
+	{IC_MEASURING,              proxy_measuring},
+	{IC_MEASUREMENT,            proxy_measurement},
+	{IC_SHOOT_FINISH,           proxy_shoot_finish},
+	{IC_UNKNOWN_8D,             proxy_initialize},
+	{IC_SETTINGS_0,             proxy_settings0},
+	{IC_SETTINGS_3,             proxy_settings3},
+	{IC_BUTTON_DISP,            proxy_button},
+	{IC_BUTTON_SET,             proxy_button},
+	{IC_AFPDLGOFF,              proxy_dialog_afoff},
+	{IC_BUTTON_WHEEL,           proxy_wheel},
+	{IC_BUTTON_UP,              proxy_button},
+	{IC_BUTTON_DOWN,            proxy_button},
+	{IC_BUTTON_RIGHT,           proxy_button},
+	{IC_BUTTON_LEFT,            proxy_button},
+	{IC_BUTTON_DP,              proxy_button},
+	{IC_BUTTON_AV,              proxy_button},
 };
 
-button_t message2button[0x100] = {
-	[IC_BUTTON_DISP]   = BUTTON_DISP,
-	[IC_BUTTON_SET]    = BUTTON_SET,
-	[IC_BUTTON_UP]     = BUTTON_UP,
-	[IC_BUTTON_DOWN]   = BUTTON_DOWN,
-	[IC_BUTTON_RIGHT]  = BUTTON_RIGHT,
-	[IC_BUTTON_LEFT]   = BUTTON_LEFT,
-	[IC_BUTTON_DP]     = BUTTON_DP,
-	[IC_BUTTON_AV]     = BUTTON_AV,
-};
+static const listeners_t listeners_script = LIST(script_listeners);
+static const listeners_t listeners_menu   = LIST(menu_listeners);
+static const listeners_t listeners_main   = LIST(main_listeners);
+
+// Listeners for the current state, see intercom_update_listeners()
+static const listeners_t *listeners = &listeners_main;
+
+/**
+ * @brief Echo of one of our own messages, expected back from the camera
+ */
+typedef struct {
+	int message;  // Message expected, or FALSE if the slot is free
+	int deadline; // Timestamp after which the echo is no longer expected
+} echo_t;
+
+static echo_t echoes[ECHO_SLOTS];
+static int    echoes_pending = 0;
 
 void message_logger (char *message);
 
+static void     echo_expect      (int message);
+static int      echo_consume     (int message);
+
+static proxy_t  listener_find    (const listeners_t *table, int message);
+static button_t message_to_button(int message);
+
 int send_to_intercom(int message, int parm) {
-	int result, length = 1;
+	int result = intercom_send(message, parm);
+
+	SleepTask(INTERCOM_WAIT);
+
+	return result;
+}
 
+/**
+ * @brief Send a message to intercom, without waiting afterwards
+ *
+ * Callers must make sure by other means that the camera has processed the
+ * message, see set_property_sync().
+ */
+int intercom_send(int message, int parm) {
 	switch (message) {
 	case IC_SET_AE:
-		status.ignore_msg = IC_SETTINGS_0;
+		echo_expect(IC_SETTINGS_0);
 		break;
 	case IC_SET_AV_VAL:
 	case IC_SET_TV_VAL:
-		status.ignore_msg = message;
+		echo_expect(message);
 		break;
+	}
+
+	return SendToIntercom(message, intercom_length(message), parm);
+}
+
+/**
+ * @brief Send a message to intercom again, when it was not applied
+ *
+ * The echo expected for the first message is not registered again: if the
+ * camera only echoes once, a second entry would hide a real change by the
+ * user for up to ECHO_TIMEOUT.
+ */
+int intercom_resend(int message, int parm) {
+	return SendToIntercom(message, intercom_length(message), parm);
+}
+
+/**
+ * @return Length of the parameter of a message, in bytes
+ */
+int intercom_length(int message) {
+	switch (message) {
 	case IC_RELEASE:
 	case IC_SET_REALTIME_ISO_0:
 	case IC_SET_REALTIME_ISO_1:
-		length = 0;
-		break;
+		return 0;
 	case IC_SET_ISO:
 	case IC_SET_AF_POINT:
 	case IC_SET_COLOR_TEMP:
-		length = 2;
-		break;
+		return 2;
+	default:
+		return 1;
 	}
-
-	result = SendToIntercom(message, length, parm);
-	SleepTask(INTERCOM_WAIT);
-
-	return result;
 }
 
 void intercom_proxy(const int handler, char *message) {
-	proxy_t  listener;
-	proxy_t *listeners;
+	proxy_t listener;
+
+	recorder_add(handler, message);
 
 #ifdef ENABLE_DEBUG
 	message_logger(message);
 #endif
 
-	if (status.ignore_msg == message [1]) {
-		status.ignore_msg = FALSE;
-	} else {
-		// Fast path for the case of a running script
-		if (status.script_running)
-			listeners = listeners_script;
-		else if (status.menu_running)
-			listeners = listeners_menu;
-		else
-			listeners = listeners_main;
+	perf_message();
 
-		if ((listener = listeners[message[1]]) != NULL)
-			if (listener(message))
-				return;
+	if (!echo_consume(message[1])) {
+		if ((listener = listener_find(listeners, message[1])) != NULL && listener(message))
+			return;
 	}
 
 	IntercomHandler(handler, message);
 }
 
+/**
+ * @brief Select the listener table for the current state
+ *
+ * Must be called whenever a script or the menu starts or stops.
+ */
+void intercom_update_listeners(void) {
+	if (status.script_running)
+		listeners = &listeners_script;
+	else if (status.menu_running)
+		listeners = &listeners_menu;
+	else
+		listeners = &listeners_main;
+}
+
+/**
+ * @brief Register a message we expect to receive as an echo of our own
+ *
+ * If all slots are in use, the one closest to expiring is reused.
+ */
+static void echo_expect(int message) {
+	int i, now = timestamp(), key = intLock();
+
+	echo_t *slot = &echoes[0];
+
+	for (i = 0; i < ECHO_SLOTS; i++) {
+		if (!echoes[i].message || echoes[i].deadline < now) {
+			slot = &echoes[i];
+			break;
+		} else if (echoes[i].deadline < slot->deadline) {
+			slot = &echoes[i];
+		}
+	}
+
+	if (!slot->message)
+		echoes_pending++;
+
+	slot->message  = message;
+	slot->deadline = now + ECHO_TIMEOUT;
+
+	intUnlock(key);
+}
+
+/**
+ * @brief Check whether a message is an expected echo, and forget it if so
+ *
+ * @return TRUE if the message was expected and must not reach the listeners
+ */
+static int echo_consume(int message) {
+	int i, now, key, result = FALSE;
+
+	if (!echoes_pending)
+		return FALSE;
+
+	now = timestamp();
+	key = intLock();
+
+	for (i = 0; i < ECHO_SLOTS; i++) {
+		if (!echoes[i].message)
+			continue;
+
+		if (echoes[i].deadline < now) {
+			echoes[i].message = FALSE;
+			echoes_pending--;
+		} else if (echoes[i].message == message && !result) {
+			echoes[i].message = FALSE;
+			echoes_pending--;
+			result = TRUE;
+		}
+	}
+
+	intUnlock(key);
+
+	return result;
+}
+
+static proxy_t listener_find(const listeners_t *table, int message) {
+	int lower = 0;
+	int upper = table->size;
+
+	while (lower < upper) {
+		int middle = (lower + upper) / 2;
+
+		if (table->data[middle].message < message)
+			lower = middle + 1;
+		else if (table->data[middle].message > message)
+			upper = middle;
+		else
+			return table->data[middle].proxy;
+	}
+
+	return NULL;
+}
+
+static button_t message_to_button(int message) {
+	switch (message) {
+	case IC_BUTTON_DISP:  return BUTTON_DISP;
+	case IC_BUTTON_SET:   return BUTTON_SET;
+	case IC_BUTTON_UP:    return BUTTON_UP;
+	case IC_BUTTON_DOWN:  return BUTTON_DOWN;
+	case IC_BUTTON_RIGHT: return BUTTON_RIGHT;
+	case IC_BUTTON_LEFT:  return BUTTON_LEFT;
+	case IC_BUTTON_DP:    return BUTTON_DP;
+	case IC_BUTTON_AV:    return BUTTON_AV;
+	default:              return BUTTON_NONE;
+	}
+}
+
 #ifdef ENABLE_DEBUG
 void message_logger(char *message) {
 	int i;
@@ -180,17 +369,61 @@ void message_logger(char *message) {
 #endif
 
 int proxy_script_restore(char *message) {
+	checkpoint_shutdown();
 	script_restore();
 
 	return FALSE;
 }
 
 int proxy_script_stop(char *message) {
-	status.script_stopping = TRUE;
+	script_cancel();
 
 	return TRUE;
 }
 
+int proxy_script_finish(char *message) {
+	status.last_shot_fl     = message[2] | (message[3] << 8);
+	status.last_finish_time = timestamp();
+
+	return FALSE;
+}
+
+int proxy_script_measure(char *message) {
+	status.measured_tv       = message[2];
+	status.measured_av       = message[3];
+	status.measured_ec       = message[4];
+	status.last_measure_time = timestamp();
+
+	return FALSE;
+}
+
+int proxy_script_battery(char *message) {
+	if (message[1] == IC_BAT_TYPE)
+		status.battery_type  = message[2];
+	else
+		script_battery(message[2]);
+
+	trace_event(TRACE_BATTERY, status.battery_level, status.battery_type);
+
+	return FALSE;
+}
+
+int proxy_script_temp(char *message) {
+	proxy_temperature(message);
+	trace_event(TRACE_TEMPERATURE, status.temperature, 0);
+
+	return FALSE;
+}
+
+/**
+ * @brief Keep the last temperature reported by the camera, also outside scripts
+ */
+int proxy_temperature(char *message) {
+	status.temperature = message[2];
+
+	return FALSE;
+}
+
 int proxy_set_language(char *message) {
 	enqueue_action(lang_pack_config);
 
@@ -255,11 +488,17 @@ int proxy_shoot_start(char *message) {
 	status.last_shot_tv = message[2];
 	status.last_shot_av = message[3];
 
+	status.last_shot_time = timestamp();
+
+	if (!status.first_shot_time)
+		status.first_shot_time = status.last_shot_time;
+
 	return FALSE;
 }
 
 int proxy_shoot_finish(char *message) {
-	status.last_shot_fl = message[2] | (message[3] << 8);
+	status.last_shot_fl     = message[2] | (message[3] << 8);
+	status.last_finish_time = timestamp();
 
 	shortcut_stop();
 
@@ -318,7 +557,7 @@ int proxy_settings3(char *message) {
 }
 
 int proxy_button(char *message) {
-	return button_handler(message2button[message[1]], message[0] > 3 ? message[2] : TRUE);
+	return button_handler(message_to_button(message[1]), message[0] > 3 ? message[2] : TRUE);
 }
 
 int proxy_wheel(char *message) {
@@ -326,32 +565,4 @@ int proxy_wheel(char *message) {
 	return button_handler((message[2] & 0x80) ? BUTTON_WHEEL_LEFT : BUTTON_WHEEL_RIGHT, TRUE);
 }
 
-int proxy_av(char *message) {
-	if (status.vf_status == VF_STATUS_FEXP)
-		enqueue_action(fexp_update_tv);
-
-	return FALSE;
-}
-
-int proxy_tv(char *message) {
-	if (settings.autoiso_enable)
-		enqueue_action(autoiso_restore);
-
-	if (status.vf_status == VF_STATUS_FEXP)
-		enqueue_action(fexp_update_av);
-
-	return FALSE;
-}
-
-int proxy_aeb(char *message) {
-	persist.aeb = message[2];
-
-	if (persist.aeb)
-		persist.last_aeb = persist.aeb;
-
-	if (!status.shortcut_running)
-		enqueue_action(persist_write);
-
-	return FALSE;
-}
 
@@ -7,7 +7,14 @@
 
 #define INTERCOM_WAIT 1
 
-extern void intercom_proxy   (const int handler, char *message);
-extern int  send_to_intercom (int message, int parm);
+#define ECHO_SLOTS     8 // Echoes of our own messages expected at the same time
+#define ECHO_TIMEOUT 500 // Time to wait for an echo, in ms
+
+extern void intercom_proxy            (const int handler, char *message);
+extern void intercom_update_listeners (void);
+extern int  send_to_intercom          (int message, int parm);
+extern int  intercom_send             (int message, int parm);
+extern int  intercom_resend           (int message, int parm);
+extern int  intercom_length           (int message);
 
 #endif /* INTERCOM_H_ */
@@ -26,11 +26,31 @@
 	LANG_PAIR( I_BODY_ID,            "Body ID"                   ) \
 	LANG_PAIR( I_FIRMWARE,           "Firmware"                  ) \
 	LANG_PAIR( I_OWNER,              "Owner"                     ) \
+	LANG_PAIR( S_LATENCY,            "Latency (ms)"              ) \
+	LANG_PAIR( I_LATENCY_MODE,       "Mode"                      ) \
+	LANG_PAIR( I_LATENCY_STATS,      "Stats"                     ) \
+	LANG_PAIR( I_LATENCY_LAG,        "Lag"                       ) \
+	LANG_PAIR( I_LATENCY_READY,      "Ready"                     ) \
+	LANG_PAIR( I_LATENCY_TOTAL,      "Total"                     ) \
+	LANG_PAIR( I_EXPORT,             "Export to file"            ) \
+	LANG_PAIR( I_RESET,              "Reset"                     ) \
+	LANG_PAIR( S_BOOT,               "Boot phases (ms)"          ) \
 	LANG_PAIR( I_DUMP_MEMORY,        "Dump RAM after 5s"         ) \
 	LANG_PAIR( I_MEMSPY_ENABLE,      "MemSpy Enable"             ) \
 	LANG_PAIR( I_MEMSPY_DISABLE,     "MemSpy Disable"            ) \
 	LANG_PAIR( I_DUMP_LOG_TO_FILE,   "Dump log to file"          ) \
 	LANG_PAIR( I_PRINT_INFO,         "Print info to log"         ) \
+	LANG_PAIR( I_DUMP_TRACE_TO_FILE, "Dump trace to file"        ) \
+	LANG_PAIR( I_INTERCOM_RECORD,    "Record intercom"           ) \
+	LANG_PAIR( I_DUMP_INTERCOM,      "Dump intercom record"      ) \
+	LANG_PAIR( S_PERFORMANCE,        "Performance"               ) \
+	LANG_PAIR( I_PERF_QUEUE,         "Queue now/peak"            ) \
+	LANG_PAIR( I_PERF_DROPS,         "Queue drops"               ) \
+	LANG_PAIR( I_PERF_MESSAGES,      "Msgs/s now/peak"           ) \
+	LANG_PAIR( I_PERF_READ,          "File read ms"              ) \
+	LANG_PAIR( I_PERF_WRITE,         "File write ms"             ) \
+	LANG_PAIR( I_PERF_OTHER,         "Other actions ms"          ) \
+	LANG_PAIR( I_PERF_MEMORY,        "Free memory"               ) \
 	LANG_PAIR( I_ENTER_FACTORY_MODE, "Enter factory Mode"        ) \
 	LANG_PAIR( I_EXIT_FACTORY_MODE,  "Exit  factory Mode"        ) \
 	LANG_PAIR( I_TEST_DIALOGS,       "Test dialogs"              ) \
@@ -65,11 +85,31 @@
 	LANG_PAIR( I_ACTION,             "Action"                    ) \
 	LANG_PAIR( I_REPEAT,             "Repeat"                    ) \
 	LANG_PAIR( I_INSTANT,            "Instant"                   ) \
+	LANG_PAIR( I_FAST,               "Fast trigger"              ) \
+	LANG_PAIR( I_PREARM,             "Pre-arm (MLU)"             ) \
+	LANG_PAIR( I_LATENCY,            "Latency (ms)"              ) \
+	LANG_PAIR( I_NATIVE_AEB,         "Native AEB"                ) \
+	LANG_PAIR( I_RAMP_METER,         "Follow meter"              ) \
+	LANG_PAIR( I_LAST_GAP,           "Last gap (ms)"             ) \
+	LANG_PAIR( I_MAX_GAP,            "Max gap (ms)"              ) \
+	LANG_PAIR( I_BULB_TIMING,        "Bulb timing"               ) \
 	LANG_PAIR( I_FRAMES,             "Frames"                    ) \
 	LANG_PAIR( I_STEP_EV,            "Step (EV)"                 ) \
 	LANG_PAIR( I_MANUAL_L,           "Bulb min"                  ) \
 	LANG_PAIR( I_MANUAL_R,           "Bulb max"                  ) \
 	LANG_PAIR( I_INTERVAL,           "Interval"                  ) \
+	LANG_PAIR( S_SUBSECOND,          "Sub-second"                ) \
+	LANG_PAIR( I_SUBSEC_ENABLE,      "Enable"                    ) \
+	LANG_PAIR( I_INTERVAL_MS,        "Interval (ms)"             ) \
+	LANG_PAIR( I_CALIBRATE,          "Calibrate"                 ) \
+	LANG_PAIR( I_MIN_INTERVAL,       "Min. interval (ms)"        ) \
+	LANG_PAIR( I_LOW_POWER,          "Low power"                 ) \
+	LANG_PAIR( I_BATTERY,            "Battery drop"              ) \
+	LANG_PAIR( I_BATTERY_SHOTS,      "Shots for drop"            ) \
+	LANG_PAIR( I_CARD_TIME,          "Card time left"            ) \
+	LANG_PAIR( S_BURST,              "Burst"                     ) \
+	LANG_PAIR( I_BURST_FPS,          "Frames/s"                  ) \
+	LANG_PAIR( I_BURST_STALLS,       "Buffer stalls"             ) \
 	LANG_PAIR( I_EXPOSURE,           "Exposure"                  ) \
 	LANG_PAIR( I_RAMP_T,             "Ramp size (time)"          ) \
 	LANG_PAIR( I_RAMP_S,             "Ramp size (shots)"         ) \
@@ -90,12 +130,27 @@
 	LANG_PAIR( S_HANDWAVE,           "Handwaving"                ) \
 	LANG_PAIR( S_TIMER,              "Self-Timer"                ) \
 	LANG_PAIR( S_LEXP,               "Long exposures"            ) \
+	LANG_PAIR( S_TRAILS,             "Star trails"               ) \
+	LANG_PAIR( I_RESUME,             "Resume interrupted"        ) \
+	LANG_PAIR( S_PROGRAM,            "User program"              ) \
+	LANG_PAIR( I_PROGRAM,            "Program (PROGn.BIN)"       ) \
 	LANG_PAIR( S_CALCULATOR,         "Calculator"                ) \
 	LANG_PAIR( S_DOF_CALC,           "DOF Calculator"            ) \
 	LANG_PAIR( I_KEEP_POWER_ON,      "Disable power-off"         ) \
 	LANG_PAIR( I_REVIEW_OFF,         "Disable review"            ) \
 	LANG_PAIR( I_INDICATOR,          "Indicator"                 ) \
 	LANG_PAIR( I_LCD_SCRIPT,         "LCD display"               ) \
+	LANG_PAIR( I_TELEMETRY,          "Log frames"                ) \
+	LANG_PAIR( I_CALIBRATE_LAGS,     "Calibrate lags"            ) \
+	LANG_PAIR( I_SHUTTER_LAG_1ST,    "Shutter lag 1st (ms)"      ) \
+	LANG_PAIR( I_SHUTTER_LAG_2ND,    "Shutter lag 2nd (ms)"      ) \
+	LANG_PAIR( I_MIRROR_LAG_1ST,     "Mirror lag 1st (ms)"       ) \
+	LANG_PAIR( I_MIRROR_LAG_2ND,     "Mirror lag 2nd (ms)"       ) \
+	LANG_PAIR( I_TEMPERATURE,        "Temperature"               ) \
+	LANG_PAIR( I_TEMP_MAX,           "Max. temperature"          ) \
+	LANG_PAIR( I_TEMP_DELAY,         "Cooling interval"          ) \
+	LANG_PAIR( I_BATTERY_LEVEL,      "Battery level"             ) \
+	LANG_PAIR( I_BATTERY_MIN,        "Critical battery"          ) \
 	LANG_PAIR( I_BTN_JUMP,           "Jump"                      ) \
 	LANG_PAIR( I_BTN_TRASH,          "Trash"                     ) \
 	LANG_PAIR( I_CMODES_CAMERA,      "Camera"                    ) \
@@ -130,6 +185,7 @@
 	LANG_PAIR( S_QEXP,               "Config. Quick exposure"    ) \
 	LANG_PAIR( V_OFF,                "Off"                       ) \
 	LANG_PAIR( V_NO_LIMIT,           "No Limit"                  ) \
+	LANG_PAIR( V_BULB_TIMING,        "1 tick, not 1 ms"          ) \
 	LANG_PAIR( V_YES,                "Yes"                       ) \
 	LANG_PAIR( V_NO,                 "No"                        ) \
 	LANG_PAIR( V_ENABLED,            "Enabled"                   ) \
@@ -141,6 +197,7 @@
 	LANG_PAIR( V_APT_AEB,            "Apt. AEB"                  ) \
 	LANG_PAIR( V_ISO_AEB,            "ISO AEB"                   ) \
 	LANG_PAIR( V_LEXP,               "Long exp."                 ) \
+	LANG_PAIR( V_BURST,              "Burst"                     ) \
 	LANG_PAIR( V_NEW,                "New"                       ) \
 	LANG_PAIR( V_OVERWRITE,          "Overwrite"                 ) \
 	LANG_PAIR( V_APPEND,             "Append"                    ) \
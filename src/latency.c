@@ -0,0 +1,241 @@
+/**
+ * \file latency.c
+ * \brief Release latency meter
+ *
+ * Every shot taken with shutter_release() is split in phases: shutter lag
+ * (button to IC_SHOOT_START), exposure (IC_SHOOT_START to IC_SHOOT_FINISH),
+ * and time until the camera is able to release again; each phase is kept
+ * in a histogram per drive mode and image format, with count, sum, min and
+ * max, so percentiles can be estimated without storing the samples.
+ * The ready time is only known when we were waiting for the camera, so it
+ * is not recorded otherwise.
+ */
+
+#include <vxworks.h>
+#include <ioLib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "firmware.h"
+#include "firmware/camera.h"
+#include "firmware/fio.h"
+
+#include "main.h"
+#include "macros.h"
+
+#include "utils.h"
+
+#include "latency.h"
+
+// Upper limit of each bucket in the histograms, in ms; the last one is open
+static const int latency_limits[LATENCY_BUCKETS - 1] = {
+	10, 20, 30, 50, 75, 100, 150, 200, 300, 500, 750, 1000, 1500, 2000, 5000
+};
+
+static const char *latency_phases [LATENCY_PHASE_COUNT] = {"lag", "exposure", "ready", "total"};
+static const char *latency_drives [LATENCY_DRIVES]      = {"single", "burst", "timer"};
+static const char *latency_formats[LATENCY_FORMATS]     = {"JPG", "RAW", "RAW+JPG"};
+
+static latency_stats_t latency_stats[LATENCY_DRIVES][LATENCY_FORMATS][LATENCY_PHASE_COUNT];
+
+static int latency_pressed = 0; // Timestamp of the release being measured, or 0
+static int latency_drive   = 0;
+static int latency_image   = 0;
+
+static void latency_add       (latency_stats_t *stats, int value);
+static int  latency_percentile(const latency_stats_t *stats, int percent);
+
+/**
+ * @brief Start measuring a release
+ *
+ * @param time Timestamp when the shutter button was pressed
+ */
+void latency_press(int time) {
+	latency_pressed = time;
+	latency_drive   = latency_current_drive();
+	latency_image   = latency_format(DPData.img_format);
+}
+
+/**
+ * @brief Finish measuring a release, once the camera is ready again
+ *
+ * @param time  Timestamp when the camera was found ready
+ * @param exact TRUE if we were waiting for the camera, so time is when it became ready
+ */
+void latency_ready(int time, int exact) {
+	latency_stats_t *stats;
+	int started, finished;
+
+	if (!latency_pressed)
+		return;
+
+	stats    = latency_stats[latency_drive][latency_image];
+	started  = status.last_shot_time   >= latency_pressed ? status.last_shot_time   : 0;
+	finished = status.last_finish_time >= started         ? status.last_finish_time : 0;
+
+	if (started) {
+		latency_add(&stats[LATENCY_PHASE_LAG], started - latency_pressed);
+
+		if (finished)
+			latency_add(&stats[LATENCY_PHASE_EXPOSURE], finished - started);
+	}
+
+	if (exact) {
+		if (started && finished)
+			latency_add(&stats[LATENCY_PHASE_READY], time - finished);
+
+		latency_add(&stats[LATENCY_PHASE_TOTAL], time - latency_pressed);
+	}
+
+	latency_pressed = 0;
+}
+
+/**
+ * @return Number of releases measured for a drive mode and image format
+ */
+int latency_count(int drive, int format) {
+	return latency_stats[drive][format][LATENCY_PHASE_LAG].count;
+}
+
+/**
+ * @brief Print the name of a drive mode and image format, as "single RAW"
+ */
+void latency_mode(char *buffer, int drive, int format) {
+	sprintf(buffer, "%s %s", latency_drives[drive], latency_formats[format]);
+}
+
+/**
+ * @brief Print "min/avg/p95/max" for a phase, in ms
+ */
+void latency_summary(char *buffer, int drive, int format, latency_phase_t phase) {
+	const latency_stats_t *stats = &latency_stats[drive][format][phase];
+
+	if (stats->count == 0)
+		sprintf(buffer, "-");
+	else
+		sprintf(buffer, "%d/%d/%d/%d", stats->min, stats->sum / stats->count, latency_percentile(stats, 95), stats->max);
+}
+
+/**
+ * @return Index of the current drive mode in the tables
+ */
+int latency_current_drive() {
+	return MIN(MAX(DPData.drive, 0), LATENCY_DRIVES - 1);
+}
+
+/**
+ * @return Index of an image format (as in DPData.img_format) in the tables
+ */
+int latency_format(int img_format) {
+	switch (img_format & (IMG_FORMAT_JPG | IMG_FORMAT_RAW)) {
+	case IMG_FORMAT_RAW:
+		return 1;
+	case IMG_FORMAT_JPG | IMG_FORMAT_RAW:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Write all the histograms to a CSV file
+ */
+void latency_export() {
+	int  file, drive, format, phase, bucket;
+	char buffer[LATENCY_LINE];
+
+	const char *header = "drive,format,phase,count,min,avg,p95,max";
+
+	latency_stats_t *stats;
+
+	FIO_RemoveFile(MKPATH_NEW(LATENCY_FILENAME));
+
+	if ((file = FIO_OpenFile(MKPATH_NEW(LATENCY_FILENAME), O_CREAT | O_WRONLY)) == -1)
+		return;
+
+	FIO_WriteFile(file, (void*)header, strlen(header));
+
+	for (bucket = 0; bucket < LATENCY_BUCKETS - 1; bucket++) {
+		sprintf(buffer, ",<=%d", latency_limits[bucket]);
+		FIO_WriteFile(file, buffer, strlen(buffer));
+	}
+
+	sprintf(buffer, ",>%d\n", latency_limits[LATENCY_BUCKETS - 2]);
+	FIO_WriteFile(file, buffer, strlen(buffer));
+
+	for (drive = 0; drive < LATENCY_DRIVES; drive++) {
+		for (format = 0; format < LATENCY_FORMATS; format++) {
+			for (phase = 0; phase < LATENCY_PHASE_COUNT; phase++) {
+				stats = &latency_stats[drive][format][phase];
+
+				if (stats->count == 0)
+					continue;
+
+				sprintf(buffer, "%s,%s,%s,", latency_drives[drive], latency_formats[format], latency_phases[phase]);
+				FIO_WriteFile(file, buffer, strlen(buffer));
+
+				sprintf(buffer, "%d,%d,%d,", stats->count, stats->min, stats->sum / stats->count);
+				FIO_WriteFile(file, buffer, strlen(buffer));
+
+				sprintf(buffer, "%d,%d", latency_percentile(stats, 95), stats->max);
+				FIO_WriteFile(file, buffer, strlen(buffer));
+
+				for (bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+					sprintf(buffer, ",%d", stats->buckets[bucket]);
+					FIO_WriteFile(file, buffer, strlen(buffer));
+				}
+
+				FIO_WriteFile(file, "\n", 1);
+			}
+		}
+	}
+
+	FIO_CloseFile(file);
+	beep();
+}
+
+/**
+ * @brief Forget all measurements
+ */
+void latency_reset() {
+	memset(latency_stats, 0, sizeof(latency_stats));
+	latency_pressed = 0;
+}
+
+static void latency_add(latency_stats_t *stats, int value) {
+	int bucket;
+
+	if (stats->count == 0 || value < stats->min)
+		stats->min = value;
+
+	if (stats->count == 0 || value > stats->max)
+		stats->max = value;
+
+	stats->count++;
+	stats->sum += value;
+
+	for (bucket = 0; bucket < LATENCY_BUCKETS - 1; bucket++)
+		if (value <= latency_limits[bucket])
+			break;
+
+	stats->buckets[bucket]++;
+}
+
+/**
+ * @brief Estimate a percentile from the histogram
+ *
+ * @return Upper limit of the bucket holding the percentile, but never above the maximum
+ */
+static int latency_percentile(const latency_stats_t *stats, int percent) {
+	int bucket, seen = 0;
+	int rank = (stats->count * percent + 99) / 100;
+
+	for (bucket = 0; bucket < LATENCY_BUCKETS - 1; bucket++) {
+		seen += stats->buckets[bucket];
+
+		if (seen >= rank)
+			return MIN(latency_limits[bucket], stats->max);
+	}
+
+	return stats->max;
+}
@@ -0,0 +1,45 @@
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+/**
+ * \file latency.h
+ * \brief Header for latency.c
+ */
+
+#define LATENCY_FILENAME "LATENCY.CSV"
+#define LATENCY_LINE     64 // Longest piece of a line written at once, see latency_export
+
+#define LATENCY_BUCKETS 16 // Buckets in each histogram, see latency_limits
+#define LATENCY_DRIVES   3 // Single, burst, self-timer
+#define LATENCY_FORMATS  3 // JPG, RAW, RAW+JPG
+
+typedef enum {
+	LATENCY_PHASE_LAG,      // From pressing the button to IC_SHOOT_START
+	LATENCY_PHASE_EXPOSURE, // From IC_SHOOT_START to IC_SHOOT_FINISH
+	LATENCY_PHASE_READY,    // From IC_SHOOT_FINISH until the camera can release again
+	LATENCY_PHASE_TOTAL,    // From pressing the button until the camera can release again
+	LATENCY_PHASE_COUNT
+} latency_phase_t;
+
+typedef struct {
+	int count;
+	int sum;
+	int min;
+	int max;
+	int buckets[LATENCY_BUCKETS];
+} latency_stats_t;
+
+extern void latency_press(int time);
+extern void latency_ready(int time, int exact);
+
+extern int  latency_count  (int drive, int format);
+extern void latency_mode   (char *buffer, int drive, int format);
+extern void latency_summary(char *buffer, int drive, int format, latency_phase_t phase);
+
+extern int  latency_current_drive(void);
+extern int  latency_format       (int img_format);
+
+extern void latency_export(void);
+extern void latency_reset (void);
+
+#endif /* LATENCY_H_ */
@@ -12,13 +12,21 @@
 #include "macros.h"
 
 #include "cache_hacks.h"
+#include "autoiso.h"
+#include "boot.h"
 #include "button.h"
 #include "display.h"
 #include "intercom.h"
 #include "settings.h"
 #include "persist.h"
+#include "checkpoint.h"
 #include "cmodes.h"
+#include "fexp.h"
+#include "property.h"
 #include "debug.h"
+#include "perf.h"
+#include "trace.h"
+#include "utils.h"
 
 #include "main.h"
 
@@ -41,12 +49,13 @@ status_t status = {
 	msm_count         : 0,
 	msm_tv            : EV_ZERO,
 	msm_av            : EV_ZERO,
-	ignore_msg        : FALSE,
 	vf_status         : VF_STATUS_NONE,
 	lock_redraw       : FALSE,
 };
 
 void hack_relocate   (void);
+void relocate_copy   (long *to, const long *from, int size);
+void relocate_zero   (long *to, int size);
 void cache_hacks     (void);
 
 void disable_cache_clearing (void);
@@ -65,6 +74,10 @@ void action_dispatcher(void);
 
 int check_create_folder(void);
 
+static void start_up_language    (void);
+static void start_up_cmodes      (void);
+static void start_up_cmode_recall(void);
+
 /** 
  * \brief 400plus entry point.
  * 
@@ -97,16 +110,13 @@ int main(void) {
 /** 
  * \brief 0xAF: check the devinfo for more details on why this routine is needed
  * 
+ * Only the image itself is copied, as stored in AUTOEXEC.BIN; .bss is not
+ * part of the file, so it is cleared here instead. This runs from where the
+ * camera loaded us, so it must not use any global variable.
  */
 void hack_relocate(void) {
-	int i;
-
-	long *from = (long*) 0x800000;
-	long *to   = (long*) 0x7E0000;
-
-	for (i = 0; i < 0x8000; i++) {
-		to[i] = from[i];
-	}
+	relocate_copy((long*)__image_start, (long*)LOAD_ADDRESS, __image_end - __image_start);
+	relocate_zero((long*)__bss_start, __bss_end - __bss_start);
 }
 
 /**
@@ -200,15 +210,25 @@ void hack_StartConsole(void) {
  * 4. hook dialog redraw
  */
 void hack_pre_init_hook(void) {
-	action_queue = (int*)CreateMessageQueue("action_queue", 0x40);
+	boot_begin(BOOT_PRE_INIT);
+
+	action_queue = (int*)CreateMessageQueue("action_queue", ACTION_QUEUE_SIZE);
 	CreateTask("Action Dispatcher", 25, 0x2000, action_dispatcher, 0);
 
+	// Subscribe to changes of camera properties
+	property_subscribe(IC_SET_TV_VAL, autoiso_tv_changed);
+	property_subscribe(IC_SET_TV_VAL, fexp_tv_changed);
+	property_subscribe(IC_SET_AV_VAL, fexp_av_changed);
+	property_subscribe(IC_SET_AE_BKT, persist_aeb_changed);
+
 	// Hack labels in some dialogs
 	cache_fake(0xFF837FEC, ASM_BL(0xFF837FEC, &hack_item_set_label), TYPE_ICACHE);
 	cache_fake(0xFF838300, ASM_BL(0xFF838300, &hack_item_set_label), TYPE_ICACHE);
 
 	// Hack redraw on some dialogs, to prevent flickering when entering our menu
 	cache_fake(0xFF916434, ASM_B(0xFF916434, &hack_dialog_redraw), TYPE_ICACHE);
+
+	boot_end(BOOT_PRE_INIT);
 }
 
 // we can run extra code at the end of the OFW's task init
@@ -216,6 +236,8 @@ void hack_pre_init_hook(void) {
  * \brief This function installs a button handler.
  */
 void hack_post_init_hook(void) {
+	boot_begin(BOOT_POST_INIT);
+
 	// Inject our hacked_TransferScreen
 	//TransferScreen = hack_TransferScreen;
 
@@ -225,6 +247,8 @@ void hack_post_init_hook(void) {
 	// Intercept JUMP and TRASH buttons
 	SetSendButtonProc(&hack_jump_trash_events, 0);
 
+	boot_end(BOOT_POST_INIT);
+
 	// take over the vram copy locations, so we can invert the screen
 	//cache_fake(0xFF92C5D8, ASM_BL(0xFF92C5D8, &hack_invert_olc_screen), TYPE_ICACHE);
 	//cache_fake(0xFF92C5FC, ASM_BL(0xFF92C5FC, &hack_invert_olc_screen), TYPE_ICACHE);
@@ -261,34 +285,57 @@ void hack_jump_trash_events(int r0, int r1, int button) {
 // Our own thread uses this dispatcher to execute tasks
 
 void action_dispatcher(void) {
+	int start;
 	action_t action;
 
 	// Loop while receiving messages
 	for (;;) {
 		ReceiveMessageQueue(action_queue, &action, FALSE);
+		perf_dequeue();
+
+		start = timestamp();
 		action();
+		perf_action(action, timestamp() - start);
 	}
 }
 
 void enqueue_action(action_t action) {
-	TryPostMessageQueue(action_queue, (action), FALSE);
+	// Counted before posting, as the action may be taken before we return
+	perf_enqueue();
+
+	// Returns non-zero when the queue is full
+	perf_posted(TryPostMessageQueue(action_queue, (action), FALSE) == 0);
 }
 
 void start_up() {
+	boot_begin(BOOT_START_UP);
+	trace_event(TRACE_STARTUP, 0, 0);
+
 	// Check and create our 420D folder
+	boot_begin(BOOT_FOLDER);
 	status.folder_exists = check_create_folder();
+	boot_end(BOOT_FOLDER);
 
 	// Recover persisting information
+	boot_begin(BOOT_PERSIST);
 	persist_read();
+	boot_end(BOOT_PERSIST);
 
 	// Read settings from file
+	boot_begin(BOOT_SETTINGS);
 	settings_read();
+	boot_end(BOOT_SETTINGS);
+
+	// Look for a script interrupted by a power cycle
+	enqueue_action(checkpoint_init);
 
 	// If configured, start debug mode
 	if (settings.debug_on_poweron)
 		start_debug_mode();
 
 	// If configured, restore AEB
+	boot_begin(BOOT_INTERCOM);
+
 	if (settings.persist_aeb)
 		send_to_intercom(IC_SET_AE_BKT, persist.aeb);
 
@@ -305,14 +352,19 @@ void start_up() {
 	send_to_intercom(IC_SET_REALTIME_ISO_0, 0);
 	send_to_intercom(IC_SET_REALTIME_ISO_1, 0);
 
+	boot_end(BOOT_INTERCOM);
+
 	// Set current language
-	enqueue_action(lang_pack_init);
+	enqueue_action(start_up_language);
 
 	// Read custom modes configuration from file
-	enqueue_action(cmodes_read);
+	enqueue_action(start_up_cmodes);
 
 	// And optionally apply a custom mode
-	enqueue_action(cmode_recall);
+	enqueue_action(start_up_cmode_recall);
+
+	// Log the boot phases, once all the above has run
+	enqueue_action(boot_report);
 
     // turn off the blue led after it was lighten by our hack_task_MainCtrl()
 	eventproc_EdLedOff();
@@ -322,6 +374,8 @@ void start_up() {
 	CreateTask("memspy", 0x1e, 0x1000, memspy_task, 0);
 #endif
 
+	boot_end(BOOT_START_UP);
+
 #if 0
 	debug_log("=== DUMPING DDD ===");
 	printf_DDD_log( (void*)(int)(0x00007604+0x38) );
@@ -341,6 +395,26 @@ void start_up() {
 #endif
 }
 
+// Start-up actions, wrapped to time them as boot phases
+
+static void start_up_language() {
+	boot_begin(BOOT_LANGUAGE);
+	lang_pack_init();
+	boot_end(BOOT_LANGUAGE);
+}
+
+static void start_up_cmodes() {
+	boot_begin(BOOT_CMODES);
+	cmodes_read();
+	boot_end(BOOT_CMODES);
+}
+
+static void start_up_cmode_recall() {
+	boot_begin(BOOT_CMODE_RECALL);
+	cmode_recall();
+	boot_end(BOOT_CMODE_RECALL);
+}
+
 /*
  * Look for a "420D" folder, and create it if it does not exist
  */
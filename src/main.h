@@ -15,7 +15,19 @@
 #define MKPATH_OLD(FILENAME) FOLDER_ROOT "/" FILENAME
 #define MKPATH_NEW(FILENAME) FOLDER_ROOT "/" FOLDER_NAME "/" FILENAME
 
+// The camera loads AUTOEXEC.BIN at LOAD_ADDRESS, and hack_relocate moves it
+// to RELOCATION_ADDRESS; code, data and .bss must fit in RELOCATION_SIZE
+#define LOAD_ADDRESS       0x800000
+#define RELOCATION_ADDRESS 0x7E0000
+#define RELOCATION_SIZE    0x20000
+
+// Limits of our image (code and data) and of .bss, defined in link.script
+extern char __image_start[], __image_end[];
+extern char __bss_start[],   __bss_end[];
+
 // Action definitions
+#define ACTION_QUEUE_SIZE 0x40
+
 typedef void(*action_t)(void);
 
 typedef enum {
@@ -43,12 +55,26 @@ typedef struct {
 	tv_t        last_shot_tv;      // Shutter speed of the last shot taken
 	av_t        last_shot_av;      // Aperture of the last shot taken
 	int         last_shot_fl;      // Focal length during last shot
+	int         last_shot_time;    // Timestamp of the start of the last shot
+	int         first_shot_time;   // Timestamp of the start of the first shot since it was cleared, or 0
+	int         last_finish_time;  // Timestamp of the end of the last shot
+	int         last_measure_time; // Timestamp of the last measurement received while running a script
+	int         wave_latency;      // Handwaving: time from trigger to release, in ms
+	int         interval_min;      // Intervalometer: shortest sustained interval, as calibrated, in ms
+	int         interval_battery;  // Intervalometer: battery level drop in the last run
+	int         interval_shots;    // Intervalometer: shots taken in the last run
+	int         burst_fps;         // Burst action: sustained frame rate of the last burst, in 1/100 fps
+	int         burst_stalls;      // Burst action: releases held back by a full buffer since the script started
+	int         temperature;       // Temperature, as last reported by the camera while running a script
+	int         battery_level;     // Battery level, as last reported by the camera while running a script
+	int         battery_type;      // Battery type, as last reported by the camera while running a script
+	int         trails_gap;        // Star trails: gap between the last two frames, in ms
+	int         trails_gap_max;    // Star trails: largest gap between frames, in ms
 	int         fexp_ev;           // Combined exposure value for fixed exposure
 	int         msm_count;         // Multi-spot metering: count of registered points
 	int         msm_tv;            // Multi-spot metering: sum of all Tv values registered
 	int         msm_av;            // Multi-spot metering: sum of all Av values registered
 	int         msm_active;        // Multi-spot metering: is active and in M mode
-	ic_event_t  ignore_msg;        // Event to be ignored at intercom
 	vf_status_t vf_status;         // Status of viewfinder
 	int         folder_exists;     // 420D folder exists
 	int         lock_redraw;       // Lock redrawing of dialogs
@@ -6,6 +6,7 @@
 #include "main.h"
 
 #include "button.h"
+#include "intercom.h"
 #include "languages.h"
 #include "menupage.h"
 #include "menuitem.h"
@@ -74,6 +75,7 @@ void menu_close() {
 static void menu_initialize() {
 	menu_return(current_menu);
 	status.menu_running = TRUE;
+	intercom_update_listeners();
 }
 
 static void menu_destroy() {
@@ -88,6 +90,7 @@ static void menu_destroy() {
 void menu_finish(menu_t *menu) {
 	menu_event_save();
 	status.menu_running = FALSE;
+	intercom_update_listeners();
 }
 
 static int menu_event_handler(dialog_t * dialog, int *r1, gui_event_t event, int *r3, int r4, int r5, int r6, int code) {
@@ -18,6 +18,7 @@
 
 #include "firmware/gui.h"
 
+#include "main.h"
 #include "macros.h"
 
 #include "debug.h"
@@ -29,6 +30,9 @@
 #include "utils.h"
 #include "settings.h"
 #include "memspy.h"
+#include "perf.h"
+#include "recorder.h"
+#include "trace.h"
 
 #include "menu_developer.h"
 
@@ -40,10 +44,54 @@ static void test_dialog_create(const menuitem_t *menu);
 
 static void menupage_developer_dump_log  (const menuitem_t *menuitem);
 static void menupage_developer_print_info(const menuitem_t *menuitem);
+static void menupage_developer_dump_trace(const menuitem_t *menuitem);
+static void menupage_developer_dump_intercom(const menuitem_t *menuitem);
+
+static void menupage_developer_perf_open (menu_t *menu);
+static void menupage_developer_perf_reset(const menuitem_t *menuitem);
+static void menupage_developer_perf_timer(char *buffer, const perf_timer_t *timer);
+
+static int  menu_perf_drops;
+static int  menu_perf_memory;
+static char menu_perf_queue   [LP_MAX_WORD];
+static char menu_perf_messages[LP_MAX_WORD];
+static char menu_perf_read    [LP_MAX_WORD];
+static char menu_perf_write   [LP_MAX_WORD];
+static char menu_perf_other   [LP_MAX_WORD];
+static char menu_perf_actions [PERF_TOP][LP_MAX_WORD];
+
+static menuitem_t perf_items[] = {
+	MENUITEM_INFO  (0, LP_WORD(L_I_PERF_QUEUE),    menu_perf_queue),
+	MENUITEM_PARAM (0, LP_WORD(L_I_PERF_DROPS),    &menu_perf_drops),
+	MENUITEM_INFO  (0, LP_WORD(L_I_PERF_MESSAGES), menu_perf_messages),
+	MENUITEM_INFO  (0, LP_WORD(L_I_PERF_READ),     menu_perf_read),
+	MENUITEM_INFO  (0, LP_WORD(L_I_PERF_WRITE),    menu_perf_write),
+	MENUITEM_PARAM (0, LP_WORD(L_I_PERF_MEMORY),   &menu_perf_memory),
+	MENUITEM_INFO  (0, "#1",                       menu_perf_actions[0]),
+	MENUITEM_INFO  (0, "#2",                       menu_perf_actions[1]),
+	MENUITEM_INFO  (0, "#3",                       menu_perf_actions[2]),
+	MENUITEM_INFO  (0, "#4",                       menu_perf_actions[3]),
+	MENUITEM_INFO  (0, "#5",                       menu_perf_actions[4]),
+	MENUITEM_INFO  (0, LP_WORD(L_I_PERF_OTHER),    menu_perf_other),
+	MENUITEM_LAUNCH(0, LP_WORD(L_I_RESET),         menupage_developer_perf_reset),
+};
+
+static menupage_t perf_page = {
+	name    : LP_WORD(L_S_PERFORMANCE),
+	items   : LIST(perf_items),
+	actions : {
+		[MENU_EVENT_OPEN] = menupage_developer_perf_open,
+		[MENU_EVENT_AV]   = menu_return,
+	}
+};
 
 	menuitem_t menu_developer_items[] = {
 	MENUITEM_LAUNCH( MENUPAGE_DEVEL_DUMP,          LP_WORD(L_I_DUMP_LOG_TO_FILE),    menupage_developer_dump_log),
 	MENUITEM_LAUNCH( MENUPAGE_DEVEL_PRINT,         LP_WORD(L_I_PRINT_INFO),          menupage_developer_print_info),
+	MENUITEM_LAUNCH( MENUPAGE_DEVEL_TRACE,         LP_WORD(L_I_DUMP_TRACE_TO_FILE),  menupage_developer_dump_trace),
+	MENUITEM_BOOLEAN(MENUPAGE_DEVEL_RECORD,        LP_WORD(L_I_INTERCOM_RECORD),    &settings.intercom_record,  NULL),
+	MENUITEM_LAUNCH( MENUPAGE_DEVEL_RECDUMP,       LP_WORD(L_I_DUMP_INTERCOM),       menupage_developer_dump_intercom),
+	MENUITEM_SUBMENU(MENUPAGE_DEVEL_PERF,          LP_WORD(L_S_PERFORMANCE),        &perf_page, NULL),
 	MENUITEM_BOOLEAN(MENUPAGE_DEVEL_DEBUG,         LP_WORD(L_I_DEBUG_ON_POWERON),   &settings.debug_on_poweron, NULL),
 	MENUITEM_LOGFILE(MENUPAGE_DEVEL_MODE,          LP_WORD(L_I_LOGFILE_MODE),       &settings.logfile_mode,     NULL),
 #ifdef MEM_DUMP
@@ -86,6 +134,65 @@ static void menupage_developer_print_info(const menuitem_t *menuitem) {
 	print_info();
 }
 
+static void menupage_developer_dump_trace(const menuitem_t *menuitem) {
+	enqueue_action(trace_dump);
+}
+
+static void menupage_developer_dump_intercom(const menuitem_t *menuitem) {
+	enqueue_action(recorder_dump);
+}
+
+/**
+ * @brief Take a copy of the counters, and format them for display
+ *
+ * Actions are shown by address (look it up in autoexec.map), with their
+ * average and maximum time, slowest in total first.
+ */
+static void menupage_developer_perf_open(menu_t *menu) {
+	int i, count;
+
+	perf_counters_t counters;
+	const perf_action_t *top[PERF_TOP];
+
+	perf_read(&counters);
+
+	menu_perf_drops  = counters.queue_drops;
+	menu_perf_memory = perf_free_memory();
+
+	sprintf(menu_perf_queue,    "%d/%d", counters.queue_depth,   counters.queue_peak);
+	sprintf(menu_perf_messages, "%d/%d", counters.intercom_rate, counters.intercom_peak);
+
+	menupage_developer_perf_timer(menu_perf_read,  &counters.file[PERF_FILE_READ]);
+	menupage_developer_perf_timer(menu_perf_write, &counters.file[PERF_FILE_WRITE]);
+	menupage_developer_perf_timer(menu_perf_other, &counters.other);
+
+	count = perf_top(&counters, top, PERF_TOP);
+
+	for (i = 0; i < PERF_TOP; i++) {
+		if (i < count) {
+			sprintf(menu_perf_actions[i], "%06X ", (int)top[i]->action & 0xFFFFFF);
+			menupage_developer_perf_timer(menu_perf_actions[i] + 7, &top[i]->timer);
+		} else {
+			sprintf(menu_perf_actions[i], "-");
+		}
+	}
+}
+
+static void menupage_developer_perf_reset(const menuitem_t *menuitem) {
+	perf_reset();
+	menupage_developer_perf_open(NULL);
+	menu_event_display();
+}
+
+/**
+ * @brief Print "avg/max" for a timer, in ms, with the average to 1/100 ms
+ */
+static void menupage_developer_perf_timer(char *buffer, const perf_timer_t *timer) {
+	int avg = timer->count ? 100 * timer->sum / timer->count : 0;
+
+	sprintf(buffer, "%d.%02d/%d", avg / 100, avg % 100, timer->max);
+}
+
 static int test_dialog_event_handler(dialog_t * dialog, int *r1, gui_event_t event, int *r3, int r4, int r5, int r6, int code) {
 	switch (event) {
 	case GUI_BUTTON_DISP:
@@ -10,6 +10,10 @@
 enum {
 	MENUPAGE_DEVEL_DUMP,
 	MENUPAGE_DEVEL_PRINT,
+	MENUPAGE_DEVEL_TRACE,
+	MENUPAGE_DEVEL_RECORD,
+	MENUPAGE_DEVEL_RECDUMP,
+	MENUPAGE_DEVEL_PERF,
 	MENUPAGE_DEVEL_DEBUG,
 	MENUPAGE_DEVEL_MODE,
 	MENUPAGE_DEVEL_MEMORY,
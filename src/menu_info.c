@@ -5,9 +5,12 @@
 #include <vxworks.h>
 
 #include "macros.h"
+#include "main.h"
 #include "firmware.h"
 
+#include "boot.h"
 #include "languages.h"
+#include "latency.h"
 #include "menu.h"
 #include "menupage.h"
 #include "menuitem.h"
@@ -15,12 +18,64 @@
 
 #include "menu_info.h"
 
+static int  menu_info_latency_drive;
+static int  menu_info_latency_format;
+static int  menu_info_latency_count;
+static char menu_info_latency_mode [LP_MAX_WORD];
+static char menu_info_latency_stats[LATENCY_PHASE_COUNT][LP_MAX_WORD];
+
+static void menu_info_latency_open  (menu_t *menu);
+static void menu_info_latency_export(const menuitem_t *item);
+static void menu_info_latency_reset (const menuitem_t *item);
+
+static menuitem_t latency_items[] = {
+	MENUITEM_INFO  (0, LP_WORD(L_I_LATENCY_MODE),  menu_info_latency_mode),
+	MENUITEM_PARAM (0, LP_WORD(L_I_SHOTS),         &menu_info_latency_count),
+	MENUITEM_INFO  (0, LP_WORD(L_I_LATENCY_STATS), "min/avg/p95/max"),
+	MENUITEM_INFO  (0, LP_WORD(L_I_LATENCY_LAG),   menu_info_latency_stats[LATENCY_PHASE_LAG]),
+	MENUITEM_INFO  (0, LP_WORD(L_I_EXPOSURE),      menu_info_latency_stats[LATENCY_PHASE_EXPOSURE]),
+	MENUITEM_INFO  (0, LP_WORD(L_I_LATENCY_READY), menu_info_latency_stats[LATENCY_PHASE_READY]),
+	MENUITEM_INFO  (0, LP_WORD(L_I_LATENCY_TOTAL), menu_info_latency_stats[LATENCY_PHASE_TOTAL]),
+	MENUITEM_LAUNCH(0, LP_WORD(L_I_EXPORT),        menu_info_latency_export),
+	MENUITEM_LAUNCH(0, LP_WORD(L_I_RESET),         menu_info_latency_reset),
+};
+
+static menupage_t latency_page = {
+	name    : LP_WORD(L_S_LATENCY),
+	items   : LIST(latency_items),
+	actions : {
+		[MENU_EVENT_OPEN] = menu_info_latency_open,
+		[MENU_EVENT_AV]   = menu_return,
+	}
+};
+
+static char menu_info_boot[BOOT_PHASE_COUNT][LP_MAX_WORD];
+
+static void menu_info_boot_open(menu_t *menu);
+
+#define BOOT_PHASE_DEF(name, label) MENUITEM_INFO(0, label, menu_info_boot[name]),
+static menuitem_t boot_items[] = {
+	#include "boot.def"
+};
+#undef BOOT_PHASE_DEF
+
+static menupage_t boot_page = {
+	name    : LP_WORD(L_S_BOOT),
+	items   : LIST(boot_items),
+	actions : {
+		[MENU_EVENT_OPEN] = menu_info_boot_open,
+		[MENU_EVENT_AV]   = menu_return,
+	}
+};
+
 static menuitem_t menupage_info_items[] = {
 	MENUITEM_INFO (MENUPAGE_INFO_VERSION,  LP_WORD(L_I_VERSION),        VERSION),
 	MENUITEM_PARAM(MENUPAGE_INFO_RELEASE,  LP_WORD(L_I_RELEASE_COUNT), &FLAG_RELEASE_COUNT),
 	MENUITEM_PARAM(MENUPAGE_INFO_BODYID,   LP_WORD(L_I_BODY_ID),       &FLAG_BODY_ID),
 	MENUITEM_INFO (MENUPAGE_INFO_FIRMWARE, LP_WORD(L_I_FIRMWARE),       FIRMWARE_VERSION),
 	MENUITEM_INFO (MENUPAGE_INFO_OWNER,    LP_WORD(L_I_OWNER),          OWNER_NAME),
+	MENUITEM_SUBMENU(MENUPAGE_INFO_LATENCY, LP_WORD(L_S_LATENCY),     &latency_page, NULL),
+	MENUITEM_SUBMENU(MENUPAGE_INFO_BOOT,    LP_WORD(L_S_BOOT),        &boot_page,    NULL),
 };
 
 menupage_t menupage_info = {
@@ -29,3 +84,39 @@ menupage_t menupage_info = {
 	items       : LIST(menupage_info_items),
 	ordering    : menu_order.info,
 };
+
+/**
+ * @brief Show the latency of the current drive mode and image format
+ */
+static void menu_info_latency_open(menu_t *menu) {
+	int phase;
+
+	menu_info_latency_drive  = latency_current_drive();
+	menu_info_latency_format = latency_format(DPData.img_format);
+	menu_info_latency_count  = latency_count(menu_info_latency_drive, menu_info_latency_format);
+
+	latency_mode(menu_info_latency_mode, menu_info_latency_drive, menu_info_latency_format);
+
+	for (phase = 0; phase < LATENCY_PHASE_COUNT; phase++)
+		latency_summary(menu_info_latency_stats[phase], menu_info_latency_drive, menu_info_latency_format, phase);
+}
+
+static void menu_info_latency_export(const menuitem_t *item) {
+	enqueue_action(latency_export);
+}
+
+static void menu_info_latency_reset(const menuitem_t *item) {
+	latency_reset();
+	menu_info_latency_open(NULL);
+	menu_event_display();
+}
+
+/**
+ * @brief Show when each boot phase started, and how long it took
+ */
+static void menu_info_boot_open(menu_t *menu) {
+	int phase;
+
+	for (phase = 0; phase < BOOT_PHASE_COUNT; phase++)
+		boot_summary(menu_info_boot[phase], phase);
+}
@@ -13,6 +13,8 @@ enum {
 	MENUPAGE_INFO_BODYID,
 	MENUPAGE_INFO_FIRMWARE,
 	MENUPAGE_INFO_OWNER,
+	MENUPAGE_INFO_LATENCY,
+	MENUPAGE_INFO_BOOT,
 	MENUPAGE_INFO_COUNT,
 	MENUPAGE_INFO_FIRST = 0,
 	MENUPAGE_INFO_LAST  = MENUPAGE_INFO_COUNT - 1
@@ -15,6 +15,8 @@
 #include "utils.h"
 #include "intercom.h"
 #include "float.h"
+#include "checkpoint.h"
+#include "program.h"
 
 #include "menu_scripts.h"
 
@@ -28,8 +30,10 @@ int menu_scripts_fd = MENU_SCRIPTS_FD; // DOF calculator: initial focusing dista
 
 char menu_scripts_dof_min[LP_MAX_WORD], menu_scripts_dof_max[LP_MAX_WORD];
 
+char menu_scripts_burst_fps[LP_MAX_WORD];
+
 int menu_scripts_vformat = VIDEO_FORMAT_25FPS;
-int menu_scripts_rectime = 0, menu_scripts_playtime = 0;
+int menu_scripts_rectime = 0, menu_scripts_playtime = 0, menu_scripts_cardtime = 0;
 
 void menu_lexp_calc_open(menu_t *menu);
 void menu_dof_calc_open (menu_t *menu);
@@ -47,6 +51,8 @@ void menu_scripts_open_timelapse  (menu_t *menu);
 void menu_scripts_update_timelapse(const menuitem_t *item);
 void menu_scripts_calc_timelapse  (void);
 
+void menu_scripts_open_burst(menu_t *menu);
+
 void menu_scripts_ext_aeb      (const menuitem_t *item);
 void menu_scripts_efl_aeb      (const menuitem_t *item);
 void menu_scripts_apt_aeb      (const menuitem_t *item);
@@ -56,16 +62,21 @@ void menu_scripts_bramp        (const menuitem_t *item);
 void menu_scripts_wave         (const menuitem_t *item);
 void menu_scripts_self_timer   (const menuitem_t *item);
 void menu_scripts_long_exp     (const menuitem_t *item);
+void menu_scripts_trails       (const menuitem_t *item);
+void menu_scripts_program      (const menuitem_t *item);
+void menu_scripts_resume       (const menuitem_t *item);
+void menu_scripts_interval_calibrate(const menuitem_t *item);
 
 void menu_scripts_launch (action_t script);
 
 menuitem_t ext_aeb_items[] = {
-	MENUITEM_BOOLEAN(0, LP_WORD(L_I_DELAY),     &settings.eaeb_delay,     NULL),
-	MENUITEM_BRACKET(0, LP_WORD(L_I_FRAMES),    &settings.eaeb_frames,    NULL),
-	MENUITEM_EVEAEB (0, LP_WORD(L_I_STEP_EV),   &settings.eaeb_ev,        NULL),
-	MENUITEM_EAEBDIR(0, LP_WORD(L_I_DIRECTION), &settings.eaeb_direction, NULL),
-	MENUITEM_BULB   (0, LP_WORD(L_I_MANUAL_L),  &settings.eaeb_tv_min,    menu_scripts_apply_eaeb_tvmin),
-	MENUITEM_BULB   (0, LP_WORD(L_I_MANUAL_R),  &settings.eaeb_tv_max,    menu_scripts_apply_eaeb_tvmax)
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_DELAY),      &settings.eaeb_delay,     NULL),
+	MENUITEM_BRACKET(0, LP_WORD(L_I_FRAMES),     &settings.eaeb_frames,    NULL),
+	MENUITEM_EVEAEB (0, LP_WORD(L_I_STEP_EV),    &settings.eaeb_ev,        NULL),
+	MENUITEM_EAEBDIR(0, LP_WORD(L_I_DIRECTION),  &settings.eaeb_direction, NULL),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_NATIVE_AEB), &settings.eaeb_native,    NULL),
+	MENUITEM_BULB   (0, LP_WORD(L_I_MANUAL_L),   &settings.eaeb_tv_min,    menu_scripts_apply_eaeb_tvmin),
+	MENUITEM_BULB   (0, LP_WORD(L_I_MANUAL_R),   &settings.eaeb_tv_max,    menu_scripts_apply_eaeb_tvmax),
 };
 
 menuitem_t efl_aeb_items[] = {
@@ -91,14 +102,50 @@ menuitem_t iso_aeb_items[] = {
 	MENUITEM_BOOLEAN(0, "1600",             &settings.iso_aeb[4],    NULL),
 };
 
+menuitem_t subsecond_items[] = {
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_SUBSEC_ENABLE), &settings.interval_fast, menu_scripts_update_timelapse),
+	MENUITEM_MSECS  (0, LP_WORD(L_I_INTERVAL_MS),   &settings.interval_ms,   menu_scripts_update_timelapse),
+	MENUITEM_LAUNCH (0, LP_WORD(L_I_CALIBRATE),     menu_scripts_interval_calibrate),
+	MENUITEM_PARAM  (0, LP_WORD(L_I_MIN_INTERVAL),  &status.interval_min),
+};
+
+menupage_t subsecond_page = {
+	name    : LP_WORD(L_S_SUBSECOND),
+	items   : LIST(subsecond_items),
+	actions : {
+		[MENU_EVENT_AV] = menu_return,
+	}
+};
+
+menuitem_t burst_items[] = {
+	MENUITEM_BFRAMES(0, LP_WORD(L_I_FRAMES),       &settings.burst_frames, NULL),
+	MENUITEM_INFO   (0, LP_WORD(L_I_BURST_FPS),    menu_scripts_burst_fps),
+	MENUITEM_PARAM  (0, LP_WORD(L_I_BURST_STALLS), &status.burst_stalls),
+};
+
+menupage_t burst_page = {
+	name    : LP_WORD(L_S_BURST),
+	items   : LIST(burst_items),
+	actions : {
+		[MENU_EVENT_OPEN] = menu_scripts_open_burst,
+		[MENU_EVENT_AV]   = menu_return,
+	}
+};
+
 menuitem_t interval_items[] = {
-	MENUITEM_BOOLEAN(0, LP_WORD(L_I_DELAY),    &settings.interval_delay,  NULL),
-	MENUITEM_ACTION (0, LP_WORD(L_I_ACTION),   &settings.interval_action, NULL),
-	MENUITEM_TIMEOUT(0, LP_WORD(L_I_INTERVAL), &settings.interval_time,   menu_scripts_update_timelapse),
-	MENUITEM_COUNTER(0, LP_WORD(L_I_SHOTS),    &settings.interval_shots,  menu_scripts_update_timelapse),
-	MENUITEM_VFORMAT(0, LP_WORD(L_I_VFORMAT),  &menu_scripts_vformat,     menu_scripts_update_timelapse),
-	MENUITEM_INFTIME(0, LP_WORD(L_I_RECTIME),  &menu_scripts_rectime),
-	MENUITEM_INFTIME(0, LP_WORD(L_I_PLAYTIME), &menu_scripts_playtime),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_DELAY),     &settings.interval_delay,     NULL),
+	MENUITEM_ACTION (0, LP_WORD(L_I_ACTION),    &settings.interval_action,    NULL),
+	MENUITEM_TIMEOUT(0, LP_WORD(L_I_INTERVAL),  &settings.interval_time,      menu_scripts_update_timelapse),
+	MENUITEM_COUNTER(0, LP_WORD(L_I_SHOTS),     &settings.interval_shots,     menu_scripts_update_timelapse),
+	MENUITEM_VFORMAT(0, LP_WORD(L_I_VFORMAT),   &menu_scripts_vformat,        menu_scripts_update_timelapse),
+	MENUITEM_INFTIME(0, LP_WORD(L_I_RECTIME),   &menu_scripts_rectime),
+	MENUITEM_INFTIME(0, LP_WORD(L_I_PLAYTIME),  &menu_scripts_playtime),
+	MENUITEM_INFTIME(0, LP_WORD(L_I_CARD_TIME), &menu_scripts_cardtime),
+	MENUITEM_SUBMENU(0, LP_WORD(L_S_SUBSECOND), &subsecond_page,              NULL),
+	MENUITEM_SUBMENU(0, LP_WORD(L_S_BURST),     &burst_page,                  NULL),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_LOW_POWER), &settings.interval_low_power, NULL),
+	MENUITEM_PARAM  (0, LP_WORD(L_I_BATTERY),   &status.interval_battery),
+	MENUITEM_PARAM  (0, LP_WORD(L_I_BATTERY_SHOTS), &status.interval_shots),
 };
 
 menuitem_t bramp_items[] = {
@@ -110,13 +157,18 @@ menuitem_t bramp_items[] = {
 	MENUITEM_BRSHOTS(0, LP_WORD(L_I_RAMP_S),       &settings.bramp_ramp_s,    NULL),
 	MENUITEM_EVCOMP (0, LP_WORD(L_I_RAMPING_TIME), &settings.bramp_ramp_time, NULL),
 	MENUITEM_EVCOMP (0, LP_WORD(L_I_RAMPING_EXP),  &settings.bramp_ramp_exp,  NULL),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_RAMP_METER),   &settings.bramp_auto,      NULL),
+	MENUITEM_INFO   (0, LP_WORD(L_I_BULB_TIMING),  LP_WORD(L_V_BULB_TIMING)),
 };
 
 menuitem_t wave_items[] = {
 	MENUITEM_BOOLEAN(0, LP_WORD(L_I_DELAY),   &settings.wave_delay,   NULL),
 	MENUITEM_ACTION (0, LP_WORD(L_I_ACTION),  &settings.wave_action,  NULL),
 	MENUITEM_BOOLEAN(0, LP_WORD(L_I_REPEAT),  &settings.wave_repeat,  NULL),
-	MENUITEM_BOOLEAN(0, LP_WORD(L_I_INSTANT), &settings.wave_instant, NULL)
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_INSTANT), &settings.wave_instant, NULL),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_FAST),    &settings.wave_fast,    NULL),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_PREARM),  &settings.wave_prearm,  NULL),
+	MENUITEM_PARAM  (0, LP_WORD(L_I_LATENCY), &status.wave_latency),
 };
 
 menuitem_t timer_items[] = {
@@ -155,6 +207,15 @@ menuitem_t lexp_items[] = {
 	MENUITEM_SUBMENU(0, LP_WORD(L_S_CALCULATOR), &lexp_calc_page,      NULL),
 };
 
+menuitem_t trails_items[] = {
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_DELAY),    &settings.trails_delay, NULL),
+	MENUITEM_TIMEOUT(0, LP_WORD(L_I_EXPOSURE), &settings.trails_time,  NULL),
+	MENUITEM_COUNTER(0, LP_WORD(L_I_SHOTS),    &settings.trails_shots, NULL),
+	MENUITEM_PARAM  (0, LP_WORD(L_I_LAST_GAP), &status.trails_gap),
+	MENUITEM_PARAM  (0, LP_WORD(L_I_MAX_GAP),  &status.trails_gap_max),
+	MENUITEM_INFO   (0, LP_WORD(L_I_BULB_TIMING), LP_WORD(L_V_BULB_TIMING)),
+};
+
 menupage_t ext_aeb_page = {
 	name    : LP_WORD(L_S_EXT_AEB),
 	items   : LIST(ext_aeb_items),
@@ -228,6 +289,27 @@ menupage_t lexp_page = {
 	}
 };
 
+menupage_t trails_page = {
+	name    : LP_WORD(L_S_TRAILS),
+	items   : LIST(trails_items),
+	actions : {
+		[MENU_EVENT_AV] = menu_return,
+	}
+};
+
+menuitem_t program_items[] = {
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_DELAY),   &settings.program_delay, NULL),
+	MENUITEM_PSLOT  (0, LP_WORD(L_I_PROGRAM), &settings.program_slot,  NULL),
+};
+
+menupage_t program_page = {
+	name    : LP_WORD(L_S_PROGRAM),
+	items   : LIST(program_items),
+	actions : {
+		[MENU_EVENT_AV] = menu_return,
+	}
+};
+
 menupage_t dof_calc_page = {
 	name    : LP_WORD(L_S_DOF_CALC),
 	items   : LIST(dof_calc_items),
@@ -247,7 +329,10 @@ menuitem_t menupage_scripts_items[] = {
 	MENUITEM_SUBMENU(MENUPAGE_SCRIPTS_HANDWAVE, LP_WORD(L_S_HANDWAVE),  &wave_page,      menu_scripts_wave),
 	MENUITEM_SUBMENU(MENUPAGE_SCRIPTS_TIMER,    LP_WORD(L_S_TIMER),     &timer_page,     menu_scripts_self_timer),
 	MENUITEM_SUBMENU(MENUPAGE_SCRIPTS_LEXP,     LP_WORD(L_S_LEXP),      &lexp_page,      menu_scripts_long_exp),
+	MENUITEM_SUBMENU(MENUPAGE_SCRIPTS_TRAILS,   LP_WORD(L_S_TRAILS),    &trails_page,    menu_scripts_trails),
 	MENUITEM_SUBMENU(MENUPAGE_SCRIPTS_DOFC,     LP_WORD(L_S_DOF_CALC),  &dof_calc_page,  NULL),
+	MENUITEM_LAUNCH (MENUPAGE_SCRIPTS_RESUME,   LP_WORD(L_I_RESUME),    menu_scripts_resume),
+	MENUITEM_SUBMENU(MENUPAGE_SCRIPTS_PROGRAM,  LP_WORD(L_S_PROGRAM),   &program_page,   menu_scripts_program),
 };
 
 menupage_t menupage_scripts = {
@@ -339,13 +424,25 @@ void menu_scripts_open_timelapse(menu_t *menu) {
 	menu_scripts_calc_timelapse();
 }
 
+void menu_scripts_open_burst(menu_t *menu) {
+	sprintf(menu_scripts_burst_fps, "%i.%02i", status.burst_fps / 100, status.burst_fps % 100);
+}
+
 void menu_scripts_update_timelapse(const menuitem_t *item) {
 	menu_scripts_calc_timelapse();
 	menu_event_display();
 }
 
 void menu_scripts_calc_timelapse() {
-	menu_scripts_rectime  = settings.interval_shots * settings.interval_time;
+	int ticks = DPData.avail_shot / script_action_frames(settings.interval_action);
+
+	if (settings.interval_fast) {
+		menu_scripts_rectime  = settings.interval_shots * settings.interval_ms / TIME_RESOLUTION;
+		menu_scripts_cardtime = ticks * settings.interval_ms / TIME_RESOLUTION;
+	} else {
+		menu_scripts_rectime  = settings.interval_shots * settings.interval_time;
+		menu_scripts_cardtime = ticks * settings.interval_time;
+	}
 
 	switch (menu_scripts_vformat) {
 	case VIDEO_FORMAT_25FPS:
@@ -402,6 +499,25 @@ void menu_scripts_long_exp(const menuitem_t *item) {
 	menu_scripts_launch(script_long_exp);
 }
 
+void menu_scripts_interval_calibrate(const menuitem_t *item) {
+	menu_scripts_launch(script_interval_calibrate);
+}
+
+void menu_scripts_trails(const menuitem_t *item) {
+	menu_scripts_launch(script_trails);
+}
+
+void menu_scripts_program(const menuitem_t *item) {
+	menu_scripts_launch(script_program);
+}
+
+void menu_scripts_resume(const menuitem_t *item) {
+	if (checkpoint_pending())
+		menu_scripts_launch(script_resume);
+	else
+		beep();
+}
+
 void menu_scripts_launch(action_t script) {
 	enqueue_action(menu_close);
 	enqueue_action(script);
@@ -13,7 +13,10 @@ enum {
 	MENUPAGE_SCRIPTS_HANDWAVE,
 	MENUPAGE_SCRIPTS_TIMER,
 	MENUPAGE_SCRIPTS_LEXP,
+	MENUPAGE_SCRIPTS_TRAILS,
 	MENUPAGE_SCRIPTS_DOFC,
+	MENUPAGE_SCRIPTS_RESUME,
+	MENUPAGE_SCRIPTS_PROGRAM,
 	MENUPAGE_SCRIPTS_COUNT,
 	MENUPAGE_SCRIPTS_FIRST = 0,
 	MENUPAGE_SCRIPTS_LAST  = MENUPAGE_SCRIPTS_COUNT - 1
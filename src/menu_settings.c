@@ -1,5 +1,6 @@
 #include <vxworks.h>
 
+#include "main.h"
 #include "macros.h"
 
 #include "cmodes.h"
@@ -8,6 +9,7 @@
 #include "menu.h"
 #include "menupage.h"
 #include "menuitem.h"
+#include "scripts.h"
 #include "settings.h"
 #include "utils.h"
 
@@ -20,14 +22,26 @@ void menu_settings_open(menu_t *menu);
 void menu_restore_settings(const menuitem_t *item);
 void menu_restore_cmodes  (const menuitem_t *item);
 void menu_delete_cmodes   (const menuitem_t *item);
+void menu_settings_calibrate(const menuitem_t *item);
 
 void reload_language_and_refresh(const menuitem_t *item);
 
 menuitem_t scripts_items[] = {
-	MENUITEM_BOOLEAN(0, LP_WORD(L_I_KEEP_POWER_ON), &settings.keep_power_on,    NULL),
-	MENUITEM_BOOLEAN(0, LP_WORD(L_I_REVIEW_OFF),    &settings.review_off,       NULL),
-	MENUITEM_SCRLCD( 0, LP_WORD(L_I_LCD_SCRIPT),    &settings.script_lcd,       NULL),
-	MENUITEM_SCRIND( 0, LP_WORD(L_I_INDICATOR),     &settings.script_indicator, NULL),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_KEEP_POWER_ON),   &settings.keep_power_on,    NULL),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_REVIEW_OFF),      &settings.review_off,       NULL),
+	MENUITEM_SCRLCD( 0, LP_WORD(L_I_LCD_SCRIPT),      &settings.script_lcd,       NULL),
+	MENUITEM_SCRIND( 0, LP_WORD(L_I_INDICATOR),       &settings.script_indicator, NULL),
+	MENUITEM_BOOLEAN(0, LP_WORD(L_I_TELEMETRY),       &settings.telemetry,        NULL),
+	MENUITEM_LAUNCH( 0, LP_WORD(L_I_CALIBRATE_LAGS),  menu_settings_calibrate),
+	MENUITEM_PARAM(  0, LP_WORD(L_I_SHUTTER_LAG_1ST), &settings.shutter_lag_1st),
+	MENUITEM_PARAM(  0, LP_WORD(L_I_SHUTTER_LAG_2ND), &settings.shutter_lag_2nd),
+	MENUITEM_PARAM(  0, LP_WORD(L_I_MIRROR_LAG_1ST),  &settings.mirror_lag_1st),
+	MENUITEM_PARAM(  0, LP_WORD(L_I_MIRROR_LAG_2ND),  &settings.mirror_lag_2nd),
+	MENUITEM_PARAM(  0, LP_WORD(L_I_TEMPERATURE),     &status.temperature),
+	MENUITEM_LEVEL(  0, LP_WORD(L_I_TEMP_MAX),        &settings.monitor_temp_max,    NULL),
+	MENUITEM_BRTIME( 0, LP_WORD(L_I_TEMP_DELAY),      &settings.monitor_temp_delay,  NULL),
+	MENUITEM_PARAM(  0, LP_WORD(L_I_BATTERY_LEVEL),   &status.battery_level),
+	MENUITEM_LEVEL(  0, LP_WORD(L_I_BATTERY_MIN),     &settings.monitor_battery_min, NULL),
 };
 
 menuitem_t buttons_items[] = {
@@ -185,3 +199,8 @@ void menu_delete_cmodes(const menuitem_t *item) {
 	menu_return(NULL); //TODO:FixMe
 	beep();
 }
+
+void menu_settings_calibrate(const menuitem_t *item) {
+	enqueue_action(menu_close);
+	enqueue_action(script_calibrate);
+}
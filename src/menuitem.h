@@ -265,6 +265,10 @@ struct menuitem_t {
 #define MENUITEM_COUNTER(_ID_, _NAME_, _VALUE_, _ON_CHANGE_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE,    0,  9000,   1,  10, 10, TRUE,  "%4u", _ON_CHANGE_, NULL)
 #define MENUITEM_BRACKET(_ID_, _NAME_, _VALUE_, _ON_CHANGE_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE,    3,     9,   2,   2,  0, FALSE, "%1u", _ON_CHANGE_, NULL)
 #define MENUITEM_FDIST(  _ID_, _NAME_, _VALUE_, _ON_CHANGE_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE,    1,  1000,   1,  10,  0, FALSE, "%4u", _ON_CHANGE_, NULL)
+#define MENUITEM_MSECS(  _ID_, _NAME_, _VALUE_, _ON_CHANGE_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE,  200,  9990,  10, 100,  0, FALSE, "%4u", _ON_CHANGE_, NULL)
+#define MENUITEM_LEVEL(  _ID_, _NAME_, _VALUE_, _ON_CHANGE_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE,    0,   255,   1,  10,  0, TRUE,  "%3u", _ON_CHANGE_, NULL)
+#define MENUITEM_PSLOT(  _ID_, _NAME_, _VALUE_, _ON_CHANGE_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE,    1, PROGRAM_SLOTS, 1, 1, 0, FALSE, "%1u", _ON_CHANGE_, NULL)
+#define MENUITEM_BFRAMES(_ID_, _NAME_, _VALUE_, _ON_CHANGE_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE,    2,    30,   1,   5,  0, FALSE, "%2u", _ON_CHANGE_, NULL)
 #define MENUITEM_BRSHOTS(_ID_, _NAME_, _VALUE_, _ON_CHANGE_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE,    0,  9000,   1,  10, 10, FALSE, "%4u", _ON_CHANGE_, NULL)
 
 #define MENUITEM_NAMEDCT(_ID_, _NAME_, _VALUE_, _ACTION_) MENUITEM_INT(_ID_, _NAME_, _VALUE_, FALSE, 1800, 11000,  25, 100,  0, FALSE, "%5u", NULL, _ACTION_)
@@ -24,6 +24,7 @@ char *menuoptions_action_strings[SHOT_ACTION_COUNT] = {
 	[SHOT_ACTION_APT_AEB]  = LP_WORD(L_V_APT_AEB),
 	[SHOT_ACTION_ISO_AEB]  = LP_WORD(L_V_ISO_AEB),
 	[SHOT_ACTION_LONG_EXP] = LP_WORD(L_V_LEXP),
+	[SHOT_ACTION_BURST]    = LP_WORD(L_V_BURST),
 };
 
 char *menuoptions_logfile_strings[LOGFILE_MODE_COUNT] = {
@@ -18,6 +18,7 @@
 #include "utils.h"
 #include "shutter.h"
 #include "intercom.h"
+#include "property.h"
 
 #include "msm.h"
 
@@ -132,11 +133,10 @@ void msm_start(void) {
  */
 void msm_stop(void) {
 	wait_for_camera();
-	SleepTask(RELEASE_WAIT);
 
-	send_to_intercom(IC_SET_TV_VAL, msm_tv_return);
-	send_to_intercom(IC_SET_AV_VAL, msm_av_return);
-	send_to_intercom(IC_SET_AE,     msm_ae_return);
+	set_property_sync(IC_SET_TV_VAL, msm_tv_return, PROPERTY_TIMEOUT);
+	set_property_sync(IC_SET_AV_VAL, msm_av_return, PROPERTY_TIMEOUT);
+	set_property_sync(IC_SET_AE,     msm_ae_return, PROPERTY_TIMEOUT);
 
 	enqueue_action(msm_reset);
 }
@@ -0,0 +1,189 @@
+/**
+ * \file perf.c
+ * \brief Runtime performance counters
+ *
+ * Counters for the action queue, the intercom messages and file I/O, shown
+ * in the Developers' menu. They are always compiled in, so they only use
+ * the millisecond timestamp and a few additions per event; anything more
+ * expensive (sorting, rates) is done when the counters are read.
+ */
+
+#include <vxworks.h>
+#include <intLib.h>
+#include <string.h>
+
+#include "firmware.h"
+
+#include "main.h"
+#include "macros.h"
+
+#include "utils.h"
+
+#include "perf.h"
+
+static perf_counters_t perf;
+
+static int perf_window_start = 0;
+static int perf_window_count = 0;
+
+static void perf_time(perf_timer_t *timer, int time);
+
+/**
+ * @brief Count an action about to be posted to action_queue
+ *
+ * Must be called before posting, as the dispatcher may take the action
+ * (see perf_dequeue) before the poster gets to count it.
+ */
+void perf_enqueue() {
+	int key = intLock();
+
+	perf.queue_depth++;
+
+	intUnlock(key);
+}
+
+/**
+ * @brief Complete the count started by perf_enqueue
+ *
+ * @param posted FALSE if the queue was full, and the action was lost
+ */
+void perf_posted(int posted) {
+	int key = intLock();
+
+	if (posted) {
+		perf.queue_peak = MAX(perf.queue_peak, perf.queue_depth);
+	} else {
+		perf.queue_depth--;
+		perf.queue_drops++;
+	}
+
+	intUnlock(key);
+}
+
+/**
+ * @brief Count an action taken from action_queue
+ */
+void perf_dequeue() {
+	int key = intLock();
+
+	if (perf.queue_depth > 0)
+		perf.queue_depth--;
+
+	intUnlock(key);
+}
+
+/**
+ * @brief Account the time an action took to run
+ *
+ * Only called from the action dispatcher, so no locking is needed.
+ */
+void perf_action(action_t action, int time) {
+	int i;
+
+	for (i = 0; i < PERF_ACTIONS; i++) {
+		if (perf.actions[i].action == action || perf.actions[i].action == NULL) {
+			perf.actions[i].action = action;
+			perf_time(&perf.actions[i].timer, time);
+			return;
+		}
+	}
+
+	perf_time(&perf.other, time);
+}
+
+/**
+ * @brief Count a message received from the intercom
+ */
+void perf_message() {
+	int now = timestamp();
+
+	if (now - perf_window_start >= PERF_RATE_WINDOW) {
+		// A window with no messages at all means the rate is zero
+		perf.intercom_rate = now - perf_window_start < 2 * PERF_RATE_WINDOW ? perf_window_count : 0;
+		perf.intercom_peak = MAX(perf.intercom_peak, perf.intercom_rate);
+
+		perf_window_start = now;
+		perf_window_count = 0;
+	}
+
+	perf_window_count++;
+}
+
+/**
+ * @brief Account the time taken to read or write a file
+ */
+void perf_file(perf_file_t type, int time) {
+	int key = intLock();
+
+	perf_time(&perf.file[type], time);
+
+	intUnlock(key);
+}
+
+/**
+ * @brief Take a consistent copy of all counters
+ */
+void perf_read(perf_counters_t *counters) {
+	int key = intLock();
+
+	*counters = perf;
+
+	intUnlock(key);
+}
+
+/**
+ * @brief Find the actions that took the most time in total
+ *
+ * @param counters Counters returned by perf_read
+ * @param top      Filled with the slowest actions, slowest first
+ * @param size     Length of top
+ * @return Number of actions stored in top
+ */
+int perf_top(const perf_counters_t *counters, const perf_action_t *top[], int size) {
+	int i, j, count = 0;
+
+	for (i = 0; i < PERF_ACTIONS && counters->actions[i].action != NULL; i++) {
+		const perf_action_t *action = &counters->actions[i];
+
+		// Insertion sort, as only a few actions are ever kept
+		if (count < size)
+			j = count++;
+		else if (top[size - 1]->timer.sum < action->timer.sum)
+			j = size - 1;
+		else
+			continue;
+
+		for (; j > 0 && top[j - 1]->timer.sum < action->timer.sum; j--)
+			top[j] = top[j - 1];
+
+		top[j] = action;
+	}
+
+	return count;
+}
+
+/**
+ * @return Bytes left free after our image and .bss, in the region it is relocated to
+ */
+int perf_free_memory() {
+	return RELOCATION_ADDRESS + RELOCATION_SIZE - (int)__bss_end;
+}
+
+/**
+ * @brief Clear all counters, but the current depth of the queue
+ */
+void perf_reset() {
+	int key = intLock();
+	int depth = perf.queue_depth;
+
+	memset(&perf, 0, sizeof(perf));
+	perf.queue_depth = depth;
+
+	intUnlock(key);
+}
+
+static void perf_time(perf_timer_t *timer, int time) {
+	timer->count++;
+	timer->sum += time;
+	timer->max  = MAX(timer->max, time);
+}
@@ -0,0 +1,58 @@
+#ifndef PERF_H_
+#define PERF_H_
+
+/**
+ * \file perf.h
+ * \brief Header for perf.c
+ */
+
+#include "main.h"
+
+#define PERF_ACTIONS  16 // Distinct actions timed, more are only counted as "other"
+#define PERF_TOP       5 // Slowest actions shown in the menu
+
+#define PERF_RATE_WINDOW 1000 // Window to count intercom messages per second, in ms
+
+typedef enum {
+	PERF_FILE_READ,
+	PERF_FILE_WRITE,
+	PERF_FILE_COUNT
+} perf_file_t;
+
+typedef struct {
+	int count;
+	int sum;   // Milliseconds
+	int max;   // Milliseconds
+} perf_timer_t;
+
+typedef struct {
+	action_t     action;
+	perf_timer_t timer;
+} perf_action_t;
+
+typedef struct {
+	int queue_depth;     // Actions waiting in action_queue
+	int queue_peak;      // Highest depth seen
+	int queue_drops;     // Actions lost because action_queue was full
+
+	int intercom_rate;   // Messages received during the last complete window
+	int intercom_peak;   // Highest rate seen
+
+	perf_action_t actions[PERF_ACTIONS];
+	perf_timer_t  other;              // Actions not in the table
+	perf_timer_t  file[PERF_FILE_COUNT];
+} perf_counters_t;
+
+extern void perf_enqueue(void);
+extern void perf_posted (int posted);
+extern void perf_dequeue(void);
+extern void perf_action (action_t action, int time);
+extern void perf_message(void);
+extern void perf_file   (perf_file_t type, int time);
+
+extern void perf_read   (perf_counters_t *counters);
+extern int  perf_top    (const perf_counters_t *counters, const perf_action_t *top[], int size);
+extern int  perf_free_memory(void);
+extern void perf_reset  (void);
+
+#endif /* PERF_H_ */
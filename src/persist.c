@@ -6,7 +6,9 @@
 
 #include "main.h"
 #include "exposure.h"
+#include "perf.h"
 #include "scripts.h"
+#include "utils.h"
 
 #include "persist.h"
 
@@ -35,6 +37,7 @@ int persist_read(void) {
 	int result  = FALSE;
 	int file    = -1;
 	int   version = 0;
+	int   start   = timestamp();
 
 	persist_t persistent_buffer;
 
@@ -58,6 +61,8 @@ end:
 	if (file != -1)
 		FIO_CloseFile(file);
 
+	perf_file(PERF_FILE_READ, timestamp() - start);
+
 	return result;
 }
 
@@ -67,7 +72,8 @@ end:
  */
 void persist_write(void) {
 	const int version = PERSIST_VERSION;
-	int file = -1;
+	int file  = -1;
+	int start = timestamp();
 
 	if ((file = FIO_OpenFile(MKPATH_NEW(PERSIST_FILENAME), O_CREAT | O_WRONLY)) == -1)
 		if (status.folder_exists || (file = FIO_OpenFile(MKPATH_OLD(PERSIST_FILENAME), O_CREAT | O_WRONLY)) == -1)
@@ -79,4 +85,21 @@ void persist_write(void) {
 end:
 	if (file != -1)
 		FIO_CloseFile(file);
+
+	perf_file(PERF_FILE_WRITE, timestamp() - start);
+}
+
+/**
+ * @brief Observer for changes of AEB: remember the last one used
+ *
+ * @param value new AEB setting
+ */
+void persist_aeb_changed(int value) {
+	persist.aeb = value;
+
+	if (persist.aeb)
+		persist.last_aeb = persist.aeb;
+
+	if (!status.shortcut_running)
+		enqueue_action(persist_write);
 }
@@ -20,4 +20,6 @@ extern persist_t persist;
 extern int  persist_read (void);
 extern void persist_write(void);
 
+extern void persist_aeb_changed(int value);
+
 #endif
@@ -0,0 +1,230 @@
+/**
+ * \file program.c
+ * \brief Interpreter for user programs loaded from the card
+ *
+ * A program is a sequence of fixed-size instructions, compiled on the host
+ * with tools/program_asm.pl and stored as A:/420D/PROGn.BIN. The whole
+ * program is read and checked before the script starts, into a buffer of
+ * PROGRAM_SIZE instructions, so nothing is allocated nor read from the card
+ * while it runs; each instruction maps directly to the same calls used by
+ * the native scripts.
+ */
+
+#include <vxworks.h>
+#include <ioLib.h>
+#include <stdio.h>
+
+#include "firmware.h"
+#include "firmware/camera.h"
+#include "firmware/fio.h"
+
+#include "main.h"
+#include "macros.h"
+
+#include "exposure.h"
+#include "property.h"
+#include "scripts.h"
+#include "shutter.h"
+#include "trace.h"
+#include "utils.h"
+
+#include "program.h"
+
+// One more slot for the END appended after the last instruction
+static program_instr_t program_code[PROGRAM_SIZE + 1];
+static int             program_count = 0;
+
+static int program_check  (void);
+static int program_measure(int *deviation);
+
+/**
+ * @brief Read a program from the card, and check it
+ *
+ * @param slot Program number, from 1 to PROGRAM_SLOTS
+ * @return TRUE if the program is ready to run
+ */
+int program_load(int slot) {
+	int  file, result = FALSE;
+	char path[32];
+
+	program_header_t header;
+
+	program_count = 0;
+	sprintf(path, MKPATH_NEW(PROGRAM_FILENAME), slot);
+
+	if ((file = FIO_OpenFile(path, O_RDONLY)) == -1) {
+		trace_event(TRACE_PROGRAM_ERROR, slot, -1);
+		return FALSE;
+	}
+
+	if (FIO_ReadFile(file, &header, sizeof(header)) == sizeof(header) &&
+		header.magic   == PROGRAM_MAGIC   &&
+		header.version == PROGRAM_VERSION &&
+		header.count   >  0 && header.count <= PROGRAM_SIZE)
+	{
+		int size = header.count * sizeof(program_instr_t);
+
+		if (FIO_ReadFile(file, program_code, size) == size) {
+			program_count = header.count;
+			program_code[program_count].opcode = PROGRAM_OP_END;
+
+			result = program_check();
+		}
+	}
+
+	FIO_CloseFile(file);
+
+	if (!result) {
+		trace_event(TRACE_PROGRAM_ERROR, slot, program_count);
+		program_count = 0;
+	}
+
+	return result;
+}
+
+/**
+ * @brief Run the program last loaded
+ *
+ * Must be called from within a script; stops at the end of the program,
+ * or as soon as the script is cancelled.
+ */
+void program_run() {
+	int pc = 0, depth = 0, deviation = EC_ZERO;
+	int start = timestamp();
+
+	int loop_pc   [PROGRAM_DEPTH];
+	int loop_count[PROGRAM_DEPTH];
+
+	const program_instr_t *instr;
+
+	while (program_count > 0 && can_continue()) {
+		instr = &program_code[pc++];
+
+		switch (instr->opcode) {
+		case PROGRAM_OP_END:
+			return;
+		case PROGRAM_OP_AE:
+			wait_for_camera();
+			set_property_sync(IC_SET_AE, instr->value, PROPERTY_TIMEOUT);
+			break;
+		case PROGRAM_OP_TV:
+			wait_for_camera();
+			set_property_sync(IC_SET_TV_VAL, instr->value, PROPERTY_TIMEOUT);
+			break;
+		case PROGRAM_OP_AV:
+			wait_for_camera();
+			set_property_sync(IC_SET_AV_VAL, instr->value, PROPERTY_TIMEOUT);
+			break;
+		case PROGRAM_OP_ISO:
+			wait_for_camera();
+			set_property_sync(IC_SET_ISO, instr->value, PROPERTY_TIMEOUT);
+			break;
+		case PROGRAM_OP_EF:
+			wait_for_camera();
+			set_property_sync(IC_SET_EFCOMP, instr->value, PROPERTY_TIMEOUT);
+			break;
+		case PROGRAM_OP_RELEASE:
+			shutter_release();
+			break;
+		case PROGRAM_OP_BULB:
+			shutter_release_bulb(instr->value);
+			break;
+		case PROGRAM_OP_WAIT:
+			script_sleep(instr->value);
+			break;
+		case PROGRAM_OP_UNTIL:
+			script_sleep(start + instr->value - timestamp());
+			break;
+		case PROGRAM_OP_LOOP:
+			if (depth == PROGRAM_DEPTH)
+				return;
+
+			loop_pc   [depth] = pc;
+			loop_count[depth] = instr->value;
+			depth++;
+			break;
+		case PROGRAM_OP_NEXT:
+			if (depth == 0)
+				return;
+
+			// A count of zero means for ever
+			if (loop_count[depth - 1] == 0 || --loop_count[depth - 1] > 0)
+				pc = loop_pc[depth - 1];
+			else
+				depth--;
+			break;
+		case PROGRAM_OP_MEASURE:
+			program_measure(&deviation);
+			break;
+		case PROGRAM_OP_IF_LT:
+			if (deviation < instr->value)
+				pc = instr->target;
+			break;
+		case PROGRAM_OP_IF_GT:
+			if (deviation > instr->value)
+				pc = instr->target;
+			break;
+		case PROGRAM_OP_JUMP:
+			pc = instr->target;
+			break;
+		default:
+			return;
+		}
+
+		// Yield on every backward jump, so a loop with nothing to wait for
+		// cannot keep the camera busy, and can still be cancelled
+		if (pc <= instr - program_code)
+			SleepTask(EVENT_WAIT);
+	}
+}
+
+/**
+ * @brief Check a program before running it
+ *
+ * Opcodes and jump targets must be valid, and loops properly nested,
+ * so the interpreter does not need to check them while running.
+ */
+static int program_check() {
+	int i, depth = 0;
+
+	for (i = 0; i < program_count; i++) {
+		const program_instr_t *instr = &program_code[i];
+
+		if (instr->opcode >= PROGRAM_OP_COUNT || instr->target > program_count)
+			return FALSE;
+
+		if (instr->opcode == PROGRAM_OP_LOOP && ++depth > PROGRAM_DEPTH)
+			return FALSE;
+
+		if (instr->opcode == PROGRAM_OP_NEXT && --depth < 0)
+			return FALSE;
+	}
+
+	return depth == 0;
+}
+
+/**
+ * @brief Measure the scene with a half-press of the shutter button
+ *
+ * @param deviation Updated with the deviation measured by the camera (EV code),
+ * positive when the current parameters would overexpose
+ * @return TRUE if a measurement was received
+ */
+static int program_measure(int *deviation) {
+	int start = timestamp();
+
+	press_button(IC_BUTTON_HALF_SHUTTER);
+
+	while (status.last_measure_time < start && timestamp() - start < PROGRAM_METER_TIMEOUT)
+		SleepTask(EVENT_WAIT);
+
+	press_button(IC_BUTTON_HALF_SHUTTER);
+
+	if (status.last_measure_time < start)
+		return FALSE;
+
+	*deviation = status.measured_ec;
+	trace_event(TRACE_PROGRAM_MEASURE, *deviation, timestamp() - start);
+
+	return TRUE;
+}
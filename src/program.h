@@ -0,0 +1,55 @@
+#ifndef PROGRAM_H_
+#define PROGRAM_H_
+
+/**
+ * \file program.h
+ * \brief Header for program.c
+ */
+
+#define PROGRAM_FILENAME "PROG%d.BIN" // Slot number goes in the name
+#define PROGRAM_MAGIC    0x474F5250   // "PROG"
+#define PROGRAM_VERSION  0x01
+
+#define PROGRAM_SLOTS    9   // Programs the user can choose from, PROG1.BIN to PROG9.BIN
+#define PROGRAM_SIZE   256   // Maximum number of instructions in a program
+#define PROGRAM_DEPTH    8   // Maximum nesting of loops
+
+#define PROGRAM_METER_TIMEOUT 1000 // Time to wait for a measurement, in ms
+
+typedef enum {
+	PROGRAM_OP_END,     // Stop the program
+	PROGRAM_OP_AE,      // Set the AE mode to value
+	PROGRAM_OP_TV,      // Set the shutter speed to value
+	PROGRAM_OP_AV,      // Set the aperture to value
+	PROGRAM_OP_ISO,     // Set the ISO to value
+	PROGRAM_OP_EF,      // Set the flash exposure compensation to value
+	PROGRAM_OP_RELEASE, // Take a shot
+	PROGRAM_OP_BULB,    // Take a bulb exposure of value ms
+	PROGRAM_OP_WAIT,    // Wait for value ms
+	PROGRAM_OP_UNTIL,   // Wait until value ms after the start of the program
+	PROGRAM_OP_LOOP,    // Repeat up to the matching NEXT value times (0 for ever)
+	PROGRAM_OP_NEXT,    // End of a loop
+	PROGRAM_OP_MEASURE, // Measure the scene, and keep the deviation (EV) for IF_LT / IF_GT
+	PROGRAM_OP_IF_LT,   // Jump to target if the measured deviation is below value
+	PROGRAM_OP_IF_GT,   // Jump to target if the measured deviation is above value
+	PROGRAM_OP_JUMP,    // Jump to target
+	PROGRAM_OP_COUNT
+} program_op_t;
+
+typedef struct {
+	unsigned char  opcode;   // One of program_op_t
+	unsigned char  reserved;
+	unsigned short target;   // Destination of jumps, as an instruction index
+	int            value;    // Operand
+} program_instr_t;
+
+typedef struct {
+	int magic;
+	int version;
+	int count;     // Instructions following the header
+} program_header_t;
+
+extern int  program_load(int slot);
+extern void program_run (void);
+
+#endif /* PROGRAM_H_ */
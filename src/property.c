@@ -0,0 +1,231 @@
+/**
+ * \file property.c
+ * \brief Synchronous setting of camera properties
+ *
+ * Instead of sending a property and sleeping for a fixed time, hoping the
+ * camera got it, we send it and then watch the corresponding DPData field
+ * until it reflects the new value; latencies are collected per property.
+ *
+ * Changes made by the user are also reported here: modules subscribe to the
+ * properties they are interested in, and get called with the new value.
+ * Only IC_SET_* messages are decoded: the layout of the IC_SETTINGS_* blocks
+ * is unknown but for the main dial, which proxy_settings0 takes care of.
+ */
+
+#include <vxworks.h>
+#include <stdio.h>
+
+#include "firmware.h"
+#include "firmware/camera.h"
+
+#include "main.h"
+#include "macros.h"
+
+#include "intercom.h"
+#include "trace.h"
+#include "utils.h"
+
+#include "property.h"
+
+#define PROPERTY(ic, field) {ic, (long)(&(((dpr_data_t *)NULL)->field)), #field}
+
+typedef struct {
+	int         ic;     // Intercom message used to set the property
+	long        offset; // Offset of the property in DPData
+	const char *name;
+} property_t;
+
+// Each property must also be routed to property_notify in main_listeners (intercom.c)
+static const property_t properties[] = {
+	PROPERTY(IC_SET_AE,                 ae),
+	PROPERTY(IC_SET_METERING,           metering),
+	PROPERTY(IC_SET_EFCOMP,             efcomp),
+	PROPERTY(IC_SET_DRIVE,              drive),
+	PROPERTY(IC_SET_WB,                 wb),
+	PROPERTY(IC_SET_AF_POINT,           af_point),
+	PROPERTY(IC_SET_TV_VAL,             tv_val),
+	PROPERTY(IC_SET_AV_VAL,             av_val),
+	PROPERTY(IC_SET_AV_COMP,            av_comp),
+	PROPERTY(IC_SET_ISO,                iso),
+	PROPERTY(IC_SET_AE_BKT,             ae_bkt),
+	PROPERTY(IC_SET_IMG_FORMAT,         img_format),
+	PROPERTY(IC_SET_IMG_SIZE,           img_size),
+	PROPERTY(IC_SET_IMG_QUALITY,        img_quality),
+	PROPERTY(IC_SET_CF_EMIT_AUX,        cf_emit_aux),
+	PROPERTY(IC_SET_CF_EMIT_FLASH,      cf_emit_flash),
+	PROPERTY(IC_SET_CF_AEB_SEQUENCE,    cf_aeb_sequence),
+	PROPERTY(IC_SET_CF_MIRROR_UP_LOCK,  cf_mirror_up_lock),
+	PROPERTY(IC_SET_CF_FLASH_SYNC_REAR, cf_flash_sync_rear),
+	PROPERTY(IC_SET_CF_SAFETY_SHIFT,    cf_safety_shift),
+};
+
+// Upper limit of each bucket in the histogram, the last one is open
+static const int property_limits[PROPERTY_BUCKETS - 1] = {5, 10, 20, 50, 100, 200, 500};
+
+static property_stats_t property_stats[LENGTH(properties)];
+
+typedef struct {
+	int                 id;       // Index in properties[]
+	property_observer_t observer;
+} subscription_t;
+
+static subscription_t subscriptions[PROPERTY_OBSERVERS];
+static int            subscriptions_count = 0;
+
+static int  property_find  (int ic);
+static void property_record(int id, int latency);
+
+/**
+ * @brief Set a camera property and wait until DPData reflects it
+ *
+ * Properties not known to this module are sent with send_to_intercom.
+ * If the camera has not applied the value after half the timeout, the
+ * message is sent once more.
+ *
+ * @param ic      Intercom message (IC_SET_*) used to set the property
+ * @param value   New value of the property
+ * @param timeout Maximum time to wait, in ms
+ * @return TRUE if the property was confirmed, FALSE otherwise
+ */
+int set_property_sync(int ic, int value, int timeout) {
+	int id, start, elapsed, mask, resent = FALSE;
+	const int *field;
+
+	if ((id = property_find(ic)) == -1) {
+		send_to_intercom(ic, value);
+		return TRUE;
+	}
+
+	// Only the bytes sent in the message can be compared, so that negative
+	// values (EV codes from ec_sub) match what the camera stored
+	field = (const int *)((const char *)&DPData + properties[id].offset);
+	mask  = (1 << (8 * intercom_length(ic))) - 1;
+	start = timestamp();
+
+	intercom_send(ic, value);
+
+	for (;;) {
+		elapsed = timestamp() - start;
+
+		if (((*field ^ value) & mask) == 0) {
+			property_record(id, elapsed);
+			return TRUE;
+		}
+
+		if (elapsed > timeout) {
+			property_record(id, -1);
+			return FALSE;
+		}
+
+		// The echo of the first message is still expected, so do not expect another one
+		if (!resent && elapsed > timeout / 2) {
+			intercom_resend(ic, value);
+			resent = TRUE;
+		}
+
+		SleepTask(PROPERTY_POLL);
+	}
+}
+
+/**
+ * @brief Get notified when the camera reports a change of a property
+ *
+ * Observers are called from the intercom task, so they must return
+ * quickly; anything slow should be enqueued as an action. Changes are
+ * only reported while neither a script nor the menu is running.
+ *
+ * @param ic       Intercom message (IC_SET_*) that reports the property
+ * @param observer Function to be called with the new value
+ * @return TRUE if subscribed, FALSE if the property is unknown or there is no room
+ */
+int property_subscribe(int ic, property_observer_t observer) {
+	int id = property_find(ic);
+
+	if (id == -1 || subscriptions_count == PROPERTY_OBSERVERS)
+		return FALSE;
+
+	subscriptions[subscriptions_count].id       = id;
+	subscriptions[subscriptions_count].observer = observer;
+	subscriptions_count++;
+
+	return TRUE;
+}
+
+/**
+ * @brief Intercom listener: decode a property change and notify observers
+ *
+ * @param message received from intercom
+ * @return FALSE, the message is never blocked
+ */
+int property_notify(char *message) {
+	int i, value, id = property_find(message[1]);
+
+	if (id == -1)
+		return FALSE;
+
+	// Parameters longer than a byte are sent LSB first
+	value = message[2];
+
+	if (intercom_length(message[1]) == 2)
+		value |= message[3] << 8;
+
+	for (i = 0; i < subscriptions_count; i++)
+		if (subscriptions[i].id == id)
+			subscriptions[i].observer(value);
+
+	property_stats[id].changes++;
+
+	return FALSE;
+}
+
+/**
+ * @brief Print the latency histograms to the log
+ */
+void property_print_stats(void) {
+	int id, bucket;
+
+	printf("\nProperty latencies (ms): ");
+
+	for (bucket = 0; bucket < PROPERTY_BUCKETS - 1; bucket++)
+		printf("<=%d ", property_limits[bucket]);
+
+	printf(">%d timeout, changes\n", property_limits[PROPERTY_BUCKETS - 2]);
+
+	for (id = 0; id < LENGTH(properties); id++) {
+		if (property_stats[id].count || property_stats[id].timeouts || property_stats[id].changes) {
+			printf("\t%-18s:", properties[id].name);
+
+			for (bucket = 0; bucket < PROPERTY_BUCKETS; bucket++)
+				printf(" %d", property_stats[id].buckets[bucket]);
+
+			printf(" %d, %d\n", property_stats[id].timeouts, property_stats[id].changes);
+		}
+	}
+}
+
+static int property_find(int ic) {
+	int id;
+
+	for (id = 0; id < LENGTH(properties); id++)
+		if (properties[id].ic == ic)
+			return id;
+
+	return -1;
+}
+
+static void property_record(int id, int latency) {
+	int bucket;
+
+	trace_event(TRACE_PROPERTY, properties[id].ic, latency);
+
+	if (latency < 0) {
+		property_stats[id].timeouts++;
+	} else {
+		for (bucket = 0; bucket < PROPERTY_BUCKETS - 1; bucket++)
+			if (latency <= property_limits[bucket])
+				break;
+
+		property_stats[id].count++;
+		property_stats[id].buckets[bucket]++;
+	}
+}
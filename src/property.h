@@ -0,0 +1,31 @@
+#ifndef PROPERTY_H_
+#define PROPERTY_H_
+
+/**
+ * \file property.h
+ * \brief Header for property.c
+ */
+
+#define PROPERTY_TIMEOUT 500 // Default time to wait for a property to be applied, in ms
+#define PROPERTY_POLL      5 // Interval between checks of DPData, in ms
+
+#define PROPERTY_BUCKETS   8 // Buckets in the latency histogram
+#define PROPERTY_OBSERVERS 8 // Maximum number of subscriptions
+
+typedef void (*property_observer_t)(int value);
+
+typedef struct {
+	int count;                     // Properties successfully set
+	int timeouts;                  // Properties not confirmed in time
+	int buckets[PROPERTY_BUCKETS]; // Latency histogram, see property_limits
+	int changes;                   // Change events received from the camera
+} property_stats_t;
+
+extern int  set_property_sync (int ic, int value, int timeout);
+
+extern int  property_subscribe(int ic, property_observer_t observer);
+extern int  property_notify   (char *message);
+
+extern void property_print_stats(void);
+
+#endif /* PROPERTY_H_ */
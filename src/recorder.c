@@ -0,0 +1,94 @@
+/**
+ * \file recorder.c
+ * \brief Recorder of raw intercom frames
+ *
+ * When enabled, every frame seen by intercom_proxy is stored, together with
+ * a timestamp and the listener table in use, in a ring buffer in memory;
+ * the buffer can then be dumped to a file and decoded or replayed on the
+ * host with tools/recorder_tool.pl.
+ */
+
+#include <vxworks.h>
+#include <intLib.h>
+#include <ioLib.h>
+
+#include "firmware.h"
+#include "firmware/fio.h"
+
+#include "main.h"
+#include "macros.h"
+
+#include "settings.h"
+#include "utils.h"
+
+#include "recorder.h"
+
+static recorder_frame_t recorder_buffer[RECORDER_SIZE];
+static int              recorder_total = 0;
+
+/**
+ * @brief Store an intercom frame, if the recorder is enabled
+ *
+ * @param handler Intercom handler the frame is addressed to
+ * @param message Raw frame, as received by intercom_proxy
+ */
+void recorder_add(const int handler, const char *message) {
+	int i, now, key, length;
+	recorder_frame_t *frame;
+
+	if (!settings.intercom_record)
+		return;
+
+	now    = timestamp();
+	length = MIN(message[0], RECORDER_FRAME);
+
+	key   = intLock();
+	frame = &recorder_buffer[recorder_total++ % RECORDER_SIZE];
+	intUnlock(key);
+
+	frame->timestamp = now;
+	frame->handler   = handler;
+
+	if (status.script_running)
+		frame->state = RECORDER_STATE_SCRIPT;
+	else if (status.menu_running)
+		frame->state = RECORDER_STATE_MENU;
+	else
+		frame->state = RECORDER_STATE_MAIN;
+
+	for (i = 0; i < RECORDER_FRAME; i++)
+		frame->frame[i] = i < length ? message[i] : 0;
+}
+
+/**
+ * @brief Write the recorded frames to a file, oldest frame first
+ */
+void recorder_dump(void) {
+	int file  = -1;
+	int total = recorder_total;
+	int first = total > RECORDER_SIZE ? total % RECORDER_SIZE : 0;
+
+	recorder_header_t header = {
+		magic      : RECORDER_MAGIC,
+		version    : RECORDER_VERSION,
+		frame_size : sizeof(recorder_frame_t),
+		count      : total > RECORDER_SIZE ? RECORDER_SIZE : total,
+		lost       : total > RECORDER_SIZE ? total - RECORDER_SIZE : 0,
+	};
+
+	if ((file = FIO_OpenFile(MKPATH_NEW(RECORDER_FILENAME), O_CREAT | O_WRONLY)) == -1)
+		goto end;
+
+	FIO_WriteFile(file, &header, sizeof(header));
+
+	if (first)
+		FIO_WriteFile(file, &recorder_buffer[first], (RECORDER_SIZE - first) * sizeof(recorder_frame_t));
+
+	FIO_WriteFile(file, &recorder_buffer[0], (header.count - (first ? RECORDER_SIZE - first : 0)) * sizeof(recorder_frame_t));
+
+end:
+	if (file != -1)
+		FIO_CloseFile(file);
+
+	beep();
+}
@@ -0,0 +1,40 @@
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+/**
+ * \file recorder.h
+ * \brief Header for recorder.c
+ */
+
+#define RECORDER_FILENAME "INTERCOM.BIN"
+#define RECORDER_MAGIC    0x43525449 // "ITRC"
+#define RECORDER_VERSION  0x01
+
+#define RECORDER_SIZE     256 // Frames kept in memory
+#define RECORDER_FRAME     10 // Bytes kept from each frame
+
+typedef enum {
+	RECORDER_STATE_MAIN,
+	RECORDER_STATE_MENU,
+	RECORDER_STATE_SCRIPT,
+} recorder_state_t;
+
+typedef struct {
+	int            timestamp;               // Milliseconds since start-up
+	unsigned char  handler;                 // Intercom handler (low byte)
+	unsigned char  state;                   // One of recorder_state_t
+	unsigned char  frame[RECORDER_FRAME];   // Raw frame, starting with the length
+} recorder_frame_t;
+
+typedef struct {
+	int magic;
+	int version;
+	int frame_size;
+	int count;     // Frames following this header
+	int lost;      // Frames overwritten before this dump
+} recorder_header_t;
+
+extern void recorder_add (const int handler, const char *message);
+extern void recorder_dump(void);
+
+#endif /* RECORDER_H_ */
@@ -1,7 +1,12 @@
 #include <vxworks.h>
+#include <ioLib.h>
+#include <string.h>
+#include <taskLib.h>
+#include <time.h>
 
 #include "firmware.h"
 #include "firmware/camera.h"
+#include "firmware/fio.h"
 
 #include "main.h"
 #include "macros.h"
@@ -9,11 +14,16 @@
 #include "display.h"
 #include "exposure.h"
 #include "float.h"
+#include "checkpoint.h"
+#include "program.h"
 #include "persist.h"
 #include "settings.h"
 #include "utils.h"
 #include "shutter.h"
 #include "intercom.h"
+#include "property.h"
+#include "telemetry.h"
+#include "trace.h"
 
 #include "scripts.h"
 
@@ -21,7 +31,24 @@ int *feedback_task = NULL;
 
 dpr_data_t st_DPData;
 
-void script_start   (void);
+static script_t script_current = SCRIPT_NONE;
+
+// Low-power mode: no feedback, display and review off, see script_interval_run()
+static int script_low_power = FALSE;
+static int script_resuming  = FALSE; // Set before script_start when resuming from a checkpoint
+
+// Monitor: interval currently added to cool the camera down (ms), battery found critical
+static int monitor_cooling  = 0;
+static int monitor_critical = FALSE;
+
+// Cancellation token, given when the running script must stop
+static SEM_ID script_sem = NULL;
+
+void script_start   (script_t script);
+void script_interval_run(const checkpoint_t *resume);
+void script_bramp_run   (const checkpoint_t *resume);
+void script_checkpoint  (checkpoint_t *checkpoint, int shot, int target);
+int  script_resume_wait (const checkpoint_t *checkpoint);
 void script_stop    (void);
 void script_feedback(void);
 
@@ -30,17 +57,28 @@ void script_restore_parameters(void);
 void script_action(shot_action_t action);
 
 void action_ext_aeb (void);
+void action_ext_aeb_native(void);
 void action_efl_aeb (void);
 void action_apt_aeb (void);
 void action_iso_aeb (void);
 void action_long_exp(void);
+void action_burst   (void);
+
+int  script_stretch  (int delay, int period, int busy);
+int  script_card_warn(int frames, int ticks, int period);
+int  script_cooling  (void);
 
 void script_delay(int seconds);
 
-int can_continue(void);
+void wave_lift  (int *lifted);
+void wave_finish(int lifted);
+
+int  bramp_meter      (int expo, float *deviation);
+int  bramp_balance_iso(int expo, int delay);
+void bramp_log        (int file, const bramp_log_t *entry);
 
 void script_ext_aeb() {
-	script_start();
+	script_start(SCRIPT_EXT_AEB);
 
 	if (settings.eaeb_delay)
 		script_delay(SCRIPT_DELAY_START);
@@ -54,7 +92,7 @@ void script_ext_aeb() {
 }
 
 void script_efl_aeb() {
-	script_start();
+	script_start(SCRIPT_EFL_AEB);
 
 	if (settings.efl_aeb_delay)
 		script_delay(SCRIPT_DELAY_START);
@@ -68,7 +106,7 @@ void script_efl_aeb() {
 }
 
 void script_apt_aeb() {
-	script_start();
+	script_start(SCRIPT_APT_AEB);
 
 	if (settings.apt_aeb_delay)
 		script_delay(SCRIPT_DELAY_START);
@@ -82,7 +120,7 @@ void script_apt_aeb() {
 }
 
 void script_iso_aeb() {
-	script_start();
+	script_start(SCRIPT_ISO_AEB);
 
 	if (settings.iso_aeb_delay)
 		script_delay(SCRIPT_DELAY_START);
@@ -96,31 +134,79 @@ void script_iso_aeb() {
 }
 
 void script_interval() {
-	int i;
+	script_interval_run(NULL);
+}
+
+/**
+ * @brief Intervalometer
+ *
+ * @param resume Checkpoint to resume from, or NULL to start afresh
+ */
+void script_interval_run(const checkpoint_t *resume) {
+	int i, first = 0;
 	int target, gap = 0, pause = 0, jump = 0;
-	int delay = settings.interval_time * TIME_RESOLUTION;
+	int delay, period, start = 0, busy;
+	int frames, card_warned = FALSE;
+	int battery = DPData.batt_bclevel, display_off = FALSE;
+
+	checkpoint_t checkpoint = {0};
+
+	// In sub-second mode, the interval is given in ms,
+	// and the camera is polled fast enough to keep up with it
+	if (settings.interval_fast)
+		delay = settings.interval_ms;
+	else
+		delay = settings.interval_time * TIME_RESOLUTION;
+
+	script_low_power = settings.interval_low_power;
+	script_resuming  = resume != NULL;
+	script_start(SCRIPT_INTERVAL);
+
+	// In low-power mode, everything not needed to take the shots is turned off;
+	// each pause is a single timed wait, see script_sleep()
+	if (script_low_power) {
+		send_to_intercom(IC_SET_REVIEW_TIME, REVIEW_OFF);
 
-	script_start();
+		if (FLAG_DISPLAY_ON) {
+			press_button(IC_BUTTON_DISP);
+			display_off = TRUE;
+		}
+	}
 
-	if (settings.interval_delay)
+	if (resume != NULL) {
+		first = resume->shot;
+		script_delay(script_resume_wait(resume));
+	} else if (settings.interval_delay) {
 		script_delay(SCRIPT_DELAY_START);
+	}
 
-	// "target" is the timestamp when we are supposed to shot
-	target  = timestamp();
+	if (settings.interval_fast)
+		shutter_set_poll(RELEASE_POLL_FAST);
 
-	for (i = 0; i < settings.interval_shots || settings.interval_shots == 0; i++) {
+	// "target" is the timestamp when the exposure is supposed to start;
+	// each release is anticipated by the calibrated shutter lag
+	target  = timestamp() + shutter_lag(TRUE);
+	period  = delay;
+	frames  = script_action_frames(settings.interval_action);
+
+	for (i = first; i < settings.interval_shots || settings.interval_shots == 0; i++) {
 		// We pause before each shot, after waiting for the camera to finish the previous one
-		if (i > 0) {
+		if (i > first) {
 			wait_for_camera();
 
 			if (!can_continue())
 				break;
 
+			// The camera was kept busy from the start of the action until the last frame
+			// was ready; if the card cannot keep up, stretch the interval instead of missing targets
+			busy   = MAX(0, status.last_shot_time - start) + shutter_ready_avg;
+			period = script_stretch(delay + script_cooling(), period, busy);
+
 			// Calculate how much time is left until target, and wait;
 			// automatically aim for the next target, if already missed this
-			gap    = target - timestamp();
-			pause  = gap % delay;
-			pause += pause > 0 ? 0 : delay;
+			gap    = target - shutter_lag(FALSE) - timestamp();
+			pause  = gap % period;
+			pause += pause > 0 ? 0 : period;
 
 			script_delay(pause);
 		}
@@ -128,31 +214,72 @@ void script_interval() {
 		if (!can_continue())
 			break;
 
+		if (!card_warned)
+			card_warned = script_card_warn(frames, settings.interval_shots ? settings.interval_shots - i : 0, period);
+
+		telemetry_plan(target - shutter_lag(i == first));
+
+		start = timestamp();
 		script_action(settings.interval_action);
 
 		// Recalculate the next target,
 		// but considering we may have already missed it
-		jump    = (pause % delay) - gap;
-		jump   += jump > delay ? 0 : delay;
+		jump    = (pause % period) - gap;
+		jump   += jump > period ? 0 : period;
 		target += jump;
+
+		if ((i + 1) % CHECKPOINT_FRAMES == 0 || monitor_critical)
+			script_checkpoint(&checkpoint, i + 1, target - shutter_lag(FALSE));
 	}
 
+	// The battery level usually drops after the shot, and the loop then stops
+	// before the checkpoint above; save it here, so no frame is repeated
+	if (monitor_critical && (i < settings.interval_shots || settings.interval_shots == 0))
+		script_checkpoint(&checkpoint, i, target - shutter_lag(FALSE));
+
+	shutter_set_poll(RELEASE_WAIT);
+
+	// Report how much battery was used, to compare both modes; the level
+	// may also rise a bit while the camera rests, which does not count
+	if (i > first) {
+		status.interval_battery = MAX(0, battery - DPData.batt_bclevel);
+		status.interval_shots   = i - first;
+		trace_event(TRACE_INTERVAL_BATTERY, status.interval_shots, status.interval_battery);
+	}
+
+	if (display_off && !FLAG_DISPLAY_ON)
+		press_button(IC_BUTTON_DISP);
+
 	script_stop();
 
 	persist.last_script = SCRIPT_INTERVAL;
 }
 
 void script_bramp() {
-	script_start();
+	script_bramp_run(NULL);
+}
+
+/**
+ * @brief Bulb ramping
+ *
+ * @param resume Checkpoint to resume from, or NULL to start afresh
+ */
+void script_bramp_run(const checkpoint_t *resume) {
+	checkpoint_t checkpoint = {0};
 
-	if (settings.bramp_delay)
+	script_resuming = resume != NULL;
+	script_start(SCRIPT_BRAMP);
+
+	if (resume != NULL)
+		script_delay(script_resume_wait(resume));
+	else if (settings.bramp_delay)
 		script_delay(SCRIPT_DELAY_START);
 
 	if (DPData.ae != AE_MODE_M)
-		send_to_intercom(IC_SET_AE,     AE_MODE_M);
+		set_property_sync(IC_SET_AE,     AE_MODE_M,   PROPERTY_TIMEOUT);
 
 	if (DPData.tv_val != TV_VAL_BULB)
-		send_to_intercom(IC_SET_TV_VAL, TV_VAL_BULB);
+		set_property_sync(IC_SET_TV_VAL, TV_VAL_BULB, PROPERTY_TIMEOUT);
 
 	float coef_s_expo, coef_s_delay, coef_t_expo, coef_t_delay;
 
@@ -172,22 +299,64 @@ void script_bramp() {
 		coef_t_delay = 0.0f;
 	}
 
-	int shot;
+	int shot, first = 0;
 
 	int start  = timestamp();
 	int target = start;
 
-	for (shot = 0; shot < settings.bramp_shots || settings.bramp_shots == 0; shot++) {
+	// Closed-loop ramping: exposure is corrected from the meter,
+	// and each frame is logged for deflickering
+	int   expo = TIME_RESOLUTION * settings.bramp_exp;
+	int   file = -1;
+	float deviation = 0.0f, filtered = 0.0f;
+
+	// When resuming, the ramp continues where it was left
+	if (resume != NULL) {
+		first    = resume->shot;
+		start   -= resume->elapsed;
+		expo     = resume->expo;
+		filtered = (float)resume->filtered / 1000.0f;
+	}
+
+	if (settings.bramp_auto) {
+		if (resume == NULL)
+			FIO_RemoveFile(MKPATH_NEW(BRAMP_FILENAME));
+
+		if ((file = FIO_OpenFile(MKPATH_NEW(BRAMP_FILENAME), O_CREAT | O_WRONLY)) != -1) {
+			if (resume == NULL)
+				bramp_log(file, NULL);
+			else
+				FIO_SeekFile(file, 0, 2/*SEEK_END*/);
+		}
+	}
+
+	for (shot = first; shot < settings.bramp_shots || settings.bramp_shots == 0; shot++) {
 		int delay = (float)TIME_RESOLUTION * (float)settings.bramp_time *
 				float_pow2((float)shot * coef_s_delay) *
 				float_pow2((float)(timestamp() - start) * coef_t_delay);
 
-		if (shot > 0) {
+		if (shot > first) {
 			wait_for_camera();
 
 			if (!can_continue())
 				break;
+		}
 
+		if (settings.bramp_auto && bramp_meter(expo, &deviation)) {
+			// Filter the measurements, and correct in small steps only when out of band
+			filtered = shot == 0 ? deviation : filtered + BRAMP_AUTO_WEIGHT * (deviation - filtered);
+
+			if (float_abs(filtered) > BRAMP_AUTO_BAND) {
+				float step = filtered > 0.0f ? MIN(filtered, BRAMP_AUTO_STEP) : MAX(filtered, -BRAMP_AUTO_STEP);
+
+				expo      = (float)expo * float_pow2(-step);
+				filtered -= step;
+			}
+
+			expo = bramp_balance_iso(expo, delay);
+		}
+
+		if (shot > first) {
 			int pause = target - timestamp();
 
 			if (pause > BRAMP_MAX_INTERVAL)
@@ -198,11 +367,13 @@ void script_bramp() {
 				beep();
 		}
 
+		telemetry_plan(target);
 		target += delay;
 
-		int expo = (float)TIME_RESOLUTION * (float)settings.bramp_exp  *
-				float_pow2((float)shot * coef_s_expo) *
-				float_pow2((float)(timestamp() - start) * coef_t_expo);
+		if (!settings.bramp_auto)
+			expo = (float)TIME_RESOLUTION * (float)settings.bramp_exp  *
+					float_pow2((float)shot * coef_s_expo) *
+					float_pow2((float)(timestamp() - start) * coef_t_expo);
 
 		if (expo > BRAMP_MAX_EXPOSURE)
 			break;
@@ -210,6 +381,47 @@ void script_bramp() {
 			shutter_release_bulb(expo);
 		else
 			beep();
+
+		if (file != -1) {
+			bramp_log_t entry = {
+				frame     : shot,
+				time      : shutter_bulb_opened - start,
+				exposure  : expo,
+				iso       : DPData.iso,
+				deviation : deviation,
+				filtered  : filtered,
+			};
+
+			bramp_log(file, &entry);
+		}
+
+		if ((shot + 1) % CHECKPOINT_FRAMES == 0 || monitor_critical) {
+			checkpoint.elapsed  = timestamp() - start;
+			checkpoint.expo     = expo;
+			checkpoint.filtered = 1000.0f * filtered;
+
+			script_checkpoint(&checkpoint, shot + 1, target);
+		}
+	}
+
+	// As in script_interval_run, save the checkpoint if the battery ran low
+	// while waiting; target is still that of the shot not taken
+	if (monitor_critical && (shot < settings.bramp_shots || settings.bramp_shots == 0)) {
+		checkpoint.elapsed  = timestamp() - start;
+		checkpoint.expo     = expo;
+		checkpoint.filtered = 1000.0f * filtered;
+
+		script_checkpoint(&checkpoint, shot, target);
+	}
+
+	if (file != -1)
+		FIO_CloseFile(file);
+
+	// The closed loop may have raised the ISO; leave it as it was, unless
+	// the run is to be resumed, as the checkpoint assumes the current one
+	if (settings.bramp_auto && !monitor_critical) {
+		wait_for_camera();
+		send_to_intercom(IC_SET_ISO, st_DPData.iso);
 	}
 
 	script_stop();
@@ -217,38 +429,215 @@ void script_bramp() {
 	persist.last_script = SCRIPT_BRAMP;
 }
 
+/**
+ * @brief Meter the scene for the closed-loop bulb ramping
+ *
+ * The camera does not meter in BULB, so we switch to the full-stop shutter
+ * speed nearest to the current exposure, half-press the shutter, and wait
+ * for a fresh IC_MEASUREMENT.
+ *
+ * @param expo      Current exposure, in ms
+ * @param deviation Returns how much the current exposure is over the metered one, in EV
+ * @return TRUE if the camera returned a measurement
+ */
+int bramp_meter(int expo, float *deviation) {
+	int  start, result = FALSE;
+	tv_t tv = EV_ROUND(ev_time(MAX(expo / TIME_RESOLUTION, 1)));
+
+	tv = MAX(tv, TV_MIN);
+
+	set_property_sync(IC_SET_TV_VAL, tv, PROPERTY_TIMEOUT);
+
+	start = timestamp();
+	press_button(IC_BUTTON_HALF_SHUTTER);
+
+	while (status.last_measure_time < start && timestamp() - start < BRAMP_METER_TIMEOUT)
+		SleepTask(EVENT_WAIT);
+
+	press_button(IC_BUTTON_HALF_SHUTTER);
+
+	if (status.last_measure_time >= start) {
+		// measured_ec is positive when overexposed at the metering speed
+		float metered = (float)TIME_RESOLUTION * float_pow2((float)(TV_SEC - tv) / 8.0f);
+
+		*deviation = float_log2((float)expo / metered) + (float)status.measured_ec / 8.0f;
+		result     = TRUE;
+	}
+
+	set_property_sync(IC_SET_TV_VAL, TV_VAL_BULB, PROPERTY_TIMEOUT);
+
+	return result;
+}
+
+/**
+ * @brief Keep a bulb exposure within limits by changing ISO in full stops
+ *
+ * @param expo  Exposure, in ms
+ * @param delay Interval between shots, in ms
+ * @return Exposure to use at the new ISO, in ms
+ */
+int bramp_balance_iso(int expo, int delay) {
+	int iso = DPData.iso;
+	int max = MIN(BRAMP_MAX_EXPOSURE, delay - BRAMP_AUTO_MARGIN);
+
+	while (expo > max && iso + EV_CODE(1, 0) <= ISO_MAX) {
+		iso  += EV_CODE(1, 0);
+		expo /= 2;
+	}
+
+	while (expo < 2 * BRAMP_MIN_EXPOSURE && iso - EV_CODE(1, 0) >= ISO_MIN) {
+		iso  -= EV_CODE(1, 0);
+		expo *= 2;
+	}
+
+	if (iso != DPData.iso)
+		set_property_sync(IC_SET_ISO, iso, PROPERTY_TIMEOUT);
+
+	return MIN(expo, max);
+}
+
+/**
+ * @brief Write a line to the closed-loop bulb ramping log
+ *
+ * @param file  Log file
+ * @param entry Frame to log, or NULL to write the header
+ */
+void bramp_log(int file, const bramp_log_t *entry) {
+	char buffer[64], iso[8];
+
+	if (entry == NULL) {
+		sprintf(buffer, "frame,time,exposure,iso,deviation,filtered\n");
+	} else {
+		iso_print(iso, entry->iso);
+		sprintf(buffer, "%d,%d,%d,%s,%d,%d\n", entry->frame, entry->time, entry->exposure, iso,
+				(int)(100.0f * entry->deviation), (int)(100.0f * entry->filtered));
+	}
+
+	FIO_WriteFile(file, buffer, strlen(buffer));
+}
+
 void script_wave() {
-	script_start();
+	int trigger, priority = 0;
+	int armed = FALSE, lifted = 0;
+
+	int poll   = settings.wave_fast ? WAVE_POLL_FAST : WAIT_USER_ACTION;
+	int prearm = settings.wave_prearm && settings.wave_action == SHOT_ACTION_SHOT && DPData.drive != DRIVE_MODE_TIMER;
+
+	script_start(SCRIPT_WAVE);
+
+	// In fast mode, make sure nothing delays us while polling the sensor
+	if (settings.wave_fast) {
+		taskPriorityGet(taskIdSelf(), &priority);
+		taskPrioritySet(taskIdSelf(), WAVE_PRIORITY);
+	}
+
+	// When pre-arming, the first press will lift the mirror and the second one will shot
+	if (prearm)
+		set_property_sync(IC_SET_CF_MIRROR_UP_LOCK, TRUE, PROPERTY_TIMEOUT);
 
 	// First, wait for the sensor to be free, just in case
 	while (can_continue() && FLAG_FACE_SENSOR)
-		SleepTask(WAIT_USER_ACTION);
+		SleepTask(poll);
 
 	do {
-		// Now, wait until something blocks the sensor
-		while (can_continue() && !FLAG_FACE_SENSOR)
-			SleepTask(WAIT_USER_ACTION);
+		if (prearm && !armed) {
+			wave_lift(&lifted);
+			armed = TRUE;
+		}
+
+		// Now, wait until something blocks the sensor; if the camera
+		// dropped the mirror meanwhile, lift it again
+		while (can_continue() && !FLAG_FACE_SENSOR) {
+			if (armed && timestamp() - lifted > WAVE_MLU_TIMEOUT + WAVE_MLU_MARGIN)
+				wave_lift(&lifted);
+
+			SleepTask(poll);
+		}
 
 		// If instant not activated, wait until sensor is free again
 		if (!settings.wave_instant) {
 			while (can_continue() && FLAG_FACE_SENSOR)
-				SleepTask(WAIT_USER_ACTION);
+				SleepTask(poll);
 		}
 
 		// Do the optional delay
 		if (settings.wave_delay)
 			script_delay(SCRIPT_DELAY_START);
 
-		// And finally fire the camera
-		if (can_continue())
+		// And finally fire the camera; latency is measured up to the first frame,
+		// and only reported if the camera actually started a shot
+		if (can_continue()) {
+			if (armed && timestamp() - lifted > WAVE_MLU_TIMEOUT - WAVE_MLU_MARGIN) {
+				// Too close to the timeout to know where the mirror is: let it drop, and lift it again
+				while (timestamp() - lifted <= WAVE_MLU_TIMEOUT + WAVE_MLU_MARGIN)
+					SleepTask(poll);
+
+				wave_lift(&lifted);
+			}
+
+			status.first_shot_time = 0;
+			trigger = timestamp();
+
 			script_action(settings.wave_action);
+			wait_for_camera();
+
+			if (status.first_shot_time >= trigger) {
+				status.wave_latency = status.first_shot_time - trigger;
+				trace_event(TRACE_WAVE_TRIGGER, prearm, status.wave_latency);
+
+				armed = FALSE;
+			} else if (prearm) {
+				// No frame was taken, so the press has only lifted the mirror
+				lifted = trigger;
+			}
+		}
 	} while (can_continue() && settings.wave_repeat);
 
+	// Do not leave the camera half way through a release
+	if (armed)
+		wave_finish(lifted);
+
+	if (settings.wave_fast)
+		taskPrioritySet(taskIdSelf(), priority);
+
 	script_stop();
 
 	persist.last_script = SCRIPT_WAVE;
 }
 
+/**
+ * @brief Lift the mirror for a pre-armed handwave
+ *
+ * @param lifted Updated with the time of the press, to know when the camera will drop the mirror
+ */
+void wave_lift(int *lifted) {
+	wait_for_camera();
+	press_button(IC_BUTTON_FULL_SHUTTER);
+
+	*lifted = timestamp();
+}
+
+/**
+ * @brief Complete a mirror lock-up cycle left pending by a cancelled handwave
+ *
+ * The cycle cannot be aborted, so it is completed with one more frame; if
+ * the camera is about to drop the mirror by itself, we just wait for that.
+ *
+ * @param lifted Time the mirror was lifted
+ */
+void wave_finish(int lifted) {
+	if (timestamp() - lifted < WAVE_MLU_TIMEOUT - WAVE_MLU_MARGIN) {
+		trace_event(TRACE_WAVE_FINISH, timestamp() - lifted, 0);
+
+		wait_for_camera();
+		press_button(IC_BUTTON_FULL_SHUTTER);
+		wait_for_camera();
+	} else {
+		while (timestamp() - lifted <= WAVE_MLU_TIMEOUT + WAVE_MLU_MARGIN)
+			SleepTask(WAIT_USER_ACTION);
+	}
+}
+
 void script_self_timer() {
 	int delay;
 
@@ -256,7 +645,7 @@ void script_self_timer() {
 	delay -= DPData.drive == DRIVE_MODE_TIMER ? SELF_TIMER_MS : 0;
 	delay  = MAX(delay, 0);
 
-	script_start();
+	script_start(SCRIPT_TIMER);
 	script_delay(delay);
 
 	if (can_continue())
@@ -269,7 +658,7 @@ void script_self_timer() {
 
 
 void script_long_exp() {
-	script_start();
+	script_start(SCRIPT_LONG_EXP);
 
 	if (settings.lexp_delay)
 		script_delay(SCRIPT_DELAY_START);
@@ -283,11 +672,249 @@ void script_long_exp() {
 	persist.last_script = SCRIPT_LONG_EXP;
 }
 
-void script_start() {
+/**
+ * @brief Measure the shortest interval the camera can sustain
+ *
+ * Takes INTERVAL_CALIBRATION_SHOTS shots as fast as possible; the first
+ * half fills the buffer, and the average time between the starts of the
+ * rest of the shots is the minimum interval for the current image format
+ * and card, which is left in status.interval_min.
+ */
+void script_interval_calibrate() {
+	int shot, first = 0;
+
+	script_start(SCRIPT_NONE);
+	shutter_set_poll(RELEASE_POLL_FAST);
+
+	for (shot = 0; shot < INTERVAL_CALIBRATION_SHOTS; shot++) {
+		if (!can_continue())
+			break;
+
+		shutter_release();
+
+		if (shot == INTERVAL_CALIBRATION_SHOTS / 2)
+			first = status.last_shot_time;
+	}
+
+	if (shot == INTERVAL_CALIBRATION_SHOTS) {
+		shot -= INTERVAL_CALIBRATION_SHOTS / 2 + 1;
+
+		status.interval_min = (status.last_shot_time - first) / shot;
+		trace_event(TRACE_INTERVAL_MIN, shot, status.interval_min);
+	}
+
+	shutter_set_poll(RELEASE_WAIT);
+	script_stop();
+}
+
+/**
+ * @brief Take consecutive bulb exposures with the smallest possible gap
+ *
+ * Used for star trails: exposure mode is set only once, and the next bulb
+ * is started as soon as the camera can release again, polling it every
+ * RELEASE_POLL_FAST ms; the gap between frames is traced and kept in
+ * status.trails_gap and status.trails_gap_max.
+ */
+void script_trails() {
+	int i, gap, closed = 0;
+	int time = settings.trails_time * TIME_RESOLUTION;
+
+	script_start(SCRIPT_TRAILS);
+
+	if (settings.trails_delay)
+		script_delay(SCRIPT_DELAY_START);
+
+	if (DPData.ae != AE_MODE_M)
+		set_property_sync(IC_SET_AE,     AE_MODE_M,   PROPERTY_TIMEOUT);
+
+	if (DPData.tv_val != TV_VAL_BULB)
+		set_property_sync(IC_SET_TV_VAL, TV_VAL_BULB, PROPERTY_TIMEOUT);
+
+	status.trails_gap     = 0;
+	status.trails_gap_max = 0;
+
+	shutter_set_poll(RELEASE_POLL_FAST);
+
+	for (i = 0; i < settings.trails_shots || settings.trails_shots == 0; i++) {
+		if (!can_continue())
+			break;
+
+		shutter_release_bulb(time);
+
+		if (i > 0) {
+			gap = shutter_bulb_opened - closed;
+
+			status.trails_gap     = gap;
+			status.trails_gap_max = MAX(status.trails_gap_max, gap);
+
+			trace_event(TRACE_TRAILS_GAP, i, gap);
+		}
+
+		closed = shutter_bulb_closed;
+	}
+
+	shutter_set_poll(RELEASE_WAIT);
+
+	script_restore_parameters();
+	script_stop();
+
+	persist.last_script = SCRIPT_TRAILS;
+}
+
+/**
+ * @brief Run a user program from the card
+ *
+ * The program is loaded before the script starts, see program.c.
+ */
+void script_program() {
+	if (!program_load(settings.program_slot)) {
+		beep();
+		return;
+	}
+
+	script_start(SCRIPT_PROGRAM);
+
+	if (settings.program_delay)
+		script_delay(SCRIPT_DELAY_START);
+
+	program_run();
+
+	script_restore_parameters();
+	script_stop();
+
+	persist.last_script = SCRIPT_PROGRAM;
+}
+
+/**
+ * @brief Measure the shutter lag with a few test releases
+ *
+ * The time from pressing the shutter button to IC_SHOOT_START is measured
+ * for LAG_CALIBRATION_SHOTS releases; the first one gives the lag for the
+ * first shot of a sequence, the average of the rest the lag for the next
+ * ones. In self-timer drive, the mirror lag is calibrated instead, as the
+ * measured time less the shutter lag.
+ */
+void script_calibrate() {
+	int shot, pressed, lag;
+	int first = 0, sum = 0;
+
+	script_start(SCRIPT_NONE);
+
+	for (shot = 0; shot < LAG_CALIBRATION_SHOTS; shot++) {
+		wait_for_camera();
+
+		if (!can_continue())
+			break;
+
+		pressed = timestamp();
+		shutter_release();
+
+		// The camera did not report the shot, measurement is not valid
+		if (status.last_shot_time < pressed)
+			break;
+
+		lag = status.last_shot_time - pressed;
+		trace_event(TRACE_LAG_SAMPLE, lag, status.last_finish_time - pressed);
+
+		if (shot == 0)
+			first = lag;
+		else
+			sum += lag;
+	}
+
+	if (shot == LAG_CALIBRATION_SHOTS) {
+		if (DPData.drive == DRIVE_MODE_TIMER) {
+			settings.mirror_lag_1st  = MAX(0, first - settings.shutter_lag_1st);
+			settings.mirror_lag_2nd  = MAX(0, sum / (shot - 1) - settings.shutter_lag_2nd);
+		} else {
+			settings.shutter_lag_1st = first;
+			settings.shutter_lag_2nd = sum / (shot - 1);
+		}
+
+		enqueue_action(settings_write);
+	}
+
+	script_stop();
+}
+
+/**
+ * @brief Resume the script interrupted by a power cycle, if any
+ */
+void script_resume() {
+	checkpoint_t checkpoint;
+
+	if (!checkpoint_take(&checkpoint))
+		return;
+
+	switch (checkpoint.script) {
+	case SCRIPT_INTERVAL:
+		script_interval_run(&checkpoint);
+		break;
+	case SCRIPT_BRAMP:
+		script_bramp_run(&checkpoint);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief Save a checkpoint of the running script
+ *
+ * Must be called right after a release, so it does not delay the next one.
+ *
+ * @param checkpoint Checkpoint, with the state of the script already filled in
+ * @param shot       Next shot to take
+ * @param target     Timestamp of the next shot
+ */
+void script_checkpoint(checkpoint_t *checkpoint, int shot, int target) {
+	checkpoint->script    = script_current;
+	checkpoint->shot      = shot;
+	checkpoint->next_time = time(NULL) + (target - timestamp()) / TIME_RESOLUTION;
+
+	checkpoint_save(checkpoint);
+}
+
+/**
+ * @return How long we must wait before taking the shot after a checkpoint, in ms
+ */
+int script_resume_wait(const checkpoint_t *checkpoint) {
+	return MAX(0, (checkpoint->next_time - time(NULL)) * TIME_RESOLUTION);
+}
+
+void script_start(script_t script) {
 	beep();
 
+	script_current = script;
+	trace_event(TRACE_SCRIPT_START, script, 0);
+	telemetry_start(script, script_resuming);
+
+	// Only scripts that take checkpoints drop the previous one, so a quick shot
+	// does not discard an interrupted run waiting to resume; a resumed run keeps
+	// it until it writes its own (see checkpoint_take)
+	if ((script == SCRIPT_INTERVAL || script == SCRIPT_BRAMP) && !script_resuming)
+		checkpoint_start();
+
+	script_resuming = FALSE;
+
+	// Forget any cancellation left from a previous script
+	if (script_sem == NULL)
+		script_sem = CreateBinarySemaphore("script_cancel", SEM_EMPTY);
+	else
+		TryTakeSemaphore(script_sem);
+
 	status.script_running  = TRUE;
 	status.script_stopping = FALSE;
+	status.burst_stalls    = 0;
+	intercom_update_listeners();
+
+	shutter_ready_reset();
+
+	monitor_cooling  = 0;
+	monitor_critical = FALSE;
+
+	status.battery_type = DPData.batt_type;
+	script_battery(DPData.batt_bclevel);
 
 	st_DPData = DPData;
 
@@ -315,7 +942,7 @@ void script_start() {
 		break;
 	}
 
-	if (settings.script_indicator != SCRIPT_INDICATOR_NONE) {
+	if (settings.script_indicator != SCRIPT_INDICATOR_NONE && !script_low_power) {
 		if (feedback_task == NULL)
 			feedback_task = CreateTask("Feedback", 5, 0x2000, script_feedback, 0);
 		else
@@ -326,10 +953,17 @@ void script_start() {
 void script_stop() {
 	beep();
 
+	trace_event(TRACE_SCRIPT_STOP, script_current, 0);
+	telemetry_stop();
+	checkpoint_clear();
+
 	status.script_running  = FALSE;
 	status.script_stopping = TRUE;
+	intercom_update_listeners();
 
 	script_restore();
+
+	script_low_power = FALSE;
 }
 
 void script_restore_parameters() {
@@ -347,6 +981,7 @@ void script_restore() {
 
 	send_to_intercom(IC_SET_CF_MIRROR_UP_LOCK, st_DPData.cf_mirror_up_lock);
 	send_to_intercom(IC_SET_AE_BKT,            st_DPData.ae_bkt);
+	send_to_intercom(IC_SET_DRIVE,             st_DPData.drive);
 
 	send_to_intercom(IC_SET_AUTO_POWER_OFF,    st_DPData.auto_power_off);
 	send_to_intercom(IC_SET_REVIEW_TIME,       st_DPData.review_time);
@@ -418,11 +1053,133 @@ void script_action(shot_action_t action) {
 	case SHOT_ACTION_LONG_EXP:
 		action_long_exp();
 		break;
+	case SHOT_ACTION_BURST:
+		action_burst();
+		break;
 	default:
 		break;
 	}
 }
 
+/**
+ * @brief Number of frames taken by an action
+ */
+int script_action_frames(int action) {
+	int i, frames = 0;
+
+	switch (action) {
+	case SHOT_ACTION_EXT_AEB:
+		return settings.eaeb_frames;
+	case SHOT_ACTION_EFL_AEB:
+		return settings.efl_aeb_frames;
+	case SHOT_ACTION_APT_AEB:
+		return settings.apt_aeb_frames;
+	case SHOT_ACTION_ISO_AEB:
+		for (i = 0; i < LENGTH(settings.iso_aeb); i++)
+			if (settings.iso_aeb[i])
+				frames++;
+
+		return MAX(frames, 1);
+	case SHOT_ACTION_BURST:
+		return settings.burst_frames;
+	default:
+		return 1;
+	}
+}
+
+/**
+ * @brief Stretch the interval while the camera stays busy for longer than it
+ *
+ * The interval grows in steps of INTERVAL_STRETCH_STEP, and only shrinks back
+ * once the camera is a whole step faster, so it does not change at every shot.
+ *
+ * @param delay  Interval set by the user, in ms
+ * @param period Interval currently in use, in ms
+ * @param busy   Time the camera was kept busy by the last action, in ms
+ * @return Interval to use from now on, in ms
+ */
+int script_stretch(int delay, int period, int busy) {
+	int needed    = busy + INTERVAL_STRETCH_MARGIN;
+	int stretched = delay;
+
+	if (needed > delay)
+		stretched = INTERVAL_STRETCH_STEP * ((needed + INTERVAL_STRETCH_STEP - 1) / INTERVAL_STRETCH_STEP);
+
+	if (stretched < period && needed > period - INTERVAL_STRETCH_STEP)
+		return period;
+
+	if (stretched != period)
+		trace_event(TRACE_INTERVAL_STRETCH, delay, stretched);
+
+	return stretched;
+}
+
+/**
+ * @brief Warn the user if the card will be full before the script ends
+ *
+ * For unlimited scripts, warn when less than CARD_WARN_TIME is left.
+ *
+ * @param frames Frames taken at each tick
+ * @param ticks  Ticks left, or 0 if unlimited
+ * @param period Time between ticks, in ms
+ * @return TRUE if the user was warned
+ */
+int script_card_warn(int frames, int ticks, int period) {
+	int left = DPData.avail_shot / frames;
+	int time = (int)((float)left * period / TIME_RESOLUTION);
+
+	if (ticks != 0 ? left >= ticks : time > CARD_WARN_TIME)
+		return FALSE;
+
+	trace_event(TRACE_CARD_WARN, DPData.avail_shot, time);
+
+	beep();
+	SleepTask(BEEP_LED_LENGTH);
+	beep();
+
+	return TRUE;
+}
+
+/**
+ * @brief Extra interval needed to let the camera cool down
+ *
+ * @return Time to add to the interval while the temperature is at or above the limit, in ms
+ */
+int script_cooling() {
+	int cooling = 0;
+
+	if (settings.monitor_temp_max && status.temperature >= settings.monitor_temp_max)
+		cooling = settings.monitor_temp_delay * TIME_RESOLUTION;
+
+	if (cooling != monitor_cooling) {
+		monitor_cooling = cooling;
+		trace_event(TRACE_COOLING, status.temperature, cooling);
+	}
+
+	return cooling;
+}
+
+/**
+ * @brief Keep the battery level reported by the camera, and check it against the critical level
+ *
+ * Called when a script starts, and from the intercom task for every new
+ * level. Once it is critical, the script must stop; the checkpoints of the
+ * scripts that take them are kept, so it can be resumed after replacing
+ * the battery.
+ */
+void script_battery(int level) {
+	status.battery_level = level;
+
+	if (monitor_critical || !settings.monitor_battery_min || level > settings.monitor_battery_min)
+		return;
+
+	monitor_critical = TRUE;
+	trace_event(TRACE_BATTERY_LOW, level, settings.monitor_battery_min);
+
+	if (script_current == SCRIPT_INTERVAL || script_current == SCRIPT_BRAMP)
+		checkpoint_shutdown();
+}
+
 void action_ext_aeb() {
 	if (DPData.tv_val == TV_VAL_BULB) {
 		tv_t tv_val;
@@ -432,17 +1189,20 @@ void action_ext_aeb() {
 
 			if (tv_val < BULB_VAL) {
 				if (DPData.tv_val != TV_VAL_BULB)
-					send_to_intercom(IC_SET_TV_VAL, TV_VAL_BULB);
+					set_property_sync(IC_SET_TV_VAL, TV_VAL_BULB, PROPERTY_TIMEOUT);
 
 				shutter_release_bulb(60 * BULB_MN(tv_val) * TIME_RESOLUTION);
 			} else {
-				send_to_intercom(IC_SET_TV_VAL, BULB_TV(tv_val));
+				set_property_sync(IC_SET_TV_VAL, BULB_TV(tv_val), PROPERTY_TIMEOUT);
 				shutter_release();
 			}
 
 			if (!can_continue())
 				break;
 		}
+	} else if (AE_IS_CREATIVE(DPData.ae) && settings.eaeb_native && DPData.ae != AE_MODE_TV &&
+			settings.eaeb_direction == EAEB_DIRECTION_BOTH && settings.eaeb_ev <= EAEB_NATIVE_MAX) {
+		action_ext_aeb_native();
 	} else if (AE_IS_CREATIVE(DPData.ae)) {
 		tv_t tv_inc, tv_dec;
 		av_t av_inc, av_dec;
@@ -469,7 +1229,7 @@ void action_ext_aeb() {
 		// Enter manual mode...
 		if (DPData.ae != AE_MODE_M) {
 			wait_for_camera();
-			send_to_intercom(IC_SET_AE, AE_MODE_M);
+			set_property_sync(IC_SET_AE, AE_MODE_M, PROPERTY_TIMEOUT);
 		}
 
 		// ...and do the rest ourselves
@@ -480,8 +1240,8 @@ void action_ext_aeb() {
 				tv_inc = tv_add(tv_inc, tv_sep);
 				av_inc = av_add(av_inc, av_sep);
 
-				send_to_intercom(IC_SET_TV_VAL, tv_inc);
-				send_to_intercom(IC_SET_AV_VAL, av_inc);
+				set_property_sync(IC_SET_TV_VAL, tv_inc, PROPERTY_TIMEOUT);
+				set_property_sync(IC_SET_AV_VAL, av_inc, PROPERTY_TIMEOUT);
 
 				shutter_release();
 				frames--;
@@ -496,8 +1256,8 @@ void action_ext_aeb() {
 				tv_dec = tv_sub(tv_dec, tv_sep);
 				av_dec = av_sub(av_dec, av_sep);
 
-				send_to_intercom(IC_SET_TV_VAL, tv_dec);
-				send_to_intercom(IC_SET_AV_VAL, av_dec);
+				set_property_sync(IC_SET_TV_VAL, tv_dec, PROPERTY_TIMEOUT);
+				set_property_sync(IC_SET_AV_VAL, av_dec, PROPERTY_TIMEOUT);
 
 				shutter_release();
 				frames--;
@@ -518,8 +1278,7 @@ void action_iso_aeb() {
 		if (settings.iso_aeb[i]) {
 			wait_for_camera();
 
-			send_to_intercom(IC_SET_ISO, 0x40 | ((i + 1) << 3));
-			SleepTask(WAIT_USER_ACTION);
+			set_property_sync(IC_SET_ISO, 0x40 | ((i + 1) << 3), PROPERTY_TIMEOUT);
 			shutter_release();
 
 			if (!can_continue())
@@ -530,6 +1289,72 @@ void action_iso_aeb() {
 	script_restore_parameters();
 }
 
+/**
+ * @brief Extended AEB built from the native AEB triplets of the camera
+ *
+ * The first triplet is taken in the current AE mode, around the metered
+ * exposure; the rest are taken in M mode around shifted shutter speeds,
+ * from the inside out, and frames left over on each side are taken one
+ * by one with AEB disabled. Only valid for a symmetric bracket with
+ * variable Tv and a step not beyond EAEB_NATIVE_MAX.
+ *
+ * The metered frame is the first of a triplet with the default sequence
+ * (0,-,+), but the second one when C.Fn AEB sequence is set to -,0,+.
+ */
+void action_ext_aeb_native() {
+	int  side   = (settings.eaeb_frames - 1) / 2;
+	int  centre = DPData.cf_aeb_sequence ? 1 : 0;
+	int  offset, count, shift, sign, i;
+	tv_t tv_base = DPData.tv_val, tv_centre;
+	av_t av_base = DPData.av_val;
+
+	set_property_sync(IC_SET_AE_BKT, settings.eaeb_ev, PROPERTY_TIMEOUT);
+
+	for (i = 0; i < 3; i++) {
+		shutter_release();
+
+		// Grab the parameters used by the camera for the metered frame
+		if (i == centre) {
+			tv_base = status.last_shot_tv;
+			av_base = status.last_shot_av;
+		}
+	}
+
+	if (!can_continue())
+		return;
+
+	wait_for_camera();
+
+	if (DPData.ae != AE_MODE_M)
+		set_property_sync(IC_SET_AE, AE_MODE_M, PROPERTY_TIMEOUT);
+
+	set_property_sync(IC_SET_AV_VAL, av_base, PROPERTY_TIMEOUT);
+
+	for (offset = 2; offset <= side; offset += count) {
+		// Use a triplet whenever enough frames are left on this side
+		count = (side - offset + 1 >= 3) ? 3 : 1;
+		shift = (count == 3) ? offset + 1 : offset;
+
+		set_property_sync(IC_SET_AE_BKT, count == 3 ? settings.eaeb_ev : EC_ZERO, PROPERTY_TIMEOUT);
+
+		for (sign = -1; sign <= 1; sign += 2) {
+			tv_centre = tv_base;
+
+			for (i = 0; i < shift; i++)
+				tv_centre = sign > 0 ? tv_add(tv_centre, settings.eaeb_ev) : tv_sub(tv_centre, settings.eaeb_ev);
+
+			wait_for_camera();
+			set_property_sync(IC_SET_TV_VAL, tv_centre, PROPERTY_TIMEOUT);
+
+			for (i = 0; i < count; i++)
+				shutter_release();
+
+			if (!can_continue())
+				return;
+		}
+	}
+}
+
 void action_efl_aeb() {
 	int frames = settings.efl_aeb_frames;
 
@@ -544,7 +1369,7 @@ void action_efl_aeb() {
 			wait_for_camera();
 
 			ef_inc = ec_add(ef_inc, settings.efl_aeb_ev);
-			send_to_intercom(IC_SET_EFCOMP, ef_inc);
+			set_property_sync(IC_SET_EFCOMP, ef_inc, PROPERTY_TIMEOUT);
 
 			shutter_release();
 			frames--;
@@ -557,7 +1382,7 @@ void action_efl_aeb() {
 			wait_for_camera();
 
 			ef_dec = ec_sub(ef_dec, settings.efl_aeb_ev);
-			send_to_intercom(IC_SET_EFCOMP, ef_dec);
+			set_property_sync(IC_SET_EFCOMP, ef_dec, PROPERTY_TIMEOUT);
 
 			shutter_release();
 			frames--;
@@ -587,7 +1412,7 @@ void action_apt_aeb() {
 	// Enter manual mode...
 	if (DPData.ae != AE_MODE_M) {
 		wait_for_camera();
-		send_to_intercom(IC_SET_AE, AE_MODE_M);
+		set_property_sync(IC_SET_AE, AE_MODE_M, PROPERTY_TIMEOUT);
 	}
 
 	// ...and do the rest ourselves
@@ -596,10 +1421,10 @@ void action_apt_aeb() {
 			wait_for_camera();
 
 			tv_inc = tv_add(tv_inc, settings.apt_aeb_ev);
-			send_to_intercom(IC_SET_TV_VAL, tv_inc);
+			set_property_sync(IC_SET_TV_VAL, tv_inc, PROPERTY_TIMEOUT);
 
 			av_inc = av_sub(av_inc, settings.apt_aeb_ev);
-			send_to_intercom(IC_SET_AV_VAL, av_inc);
+			set_property_sync(IC_SET_AV_VAL, av_inc, PROPERTY_TIMEOUT);
 
 			shutter_release();
 			frames--;
@@ -612,10 +1437,10 @@ void action_apt_aeb() {
 			wait_for_camera();
 
 			tv_dec = tv_sub(tv_dec, settings.apt_aeb_ev);
-			send_to_intercom(IC_SET_TV_VAL, tv_dec);
+			set_property_sync(IC_SET_TV_VAL, tv_dec, PROPERTY_TIMEOUT);
 
 			av_dec = av_add(av_dec, settings.apt_aeb_ev);
-			send_to_intercom(IC_SET_AV_VAL, av_dec);
+			set_property_sync(IC_SET_AV_VAL, av_dec, PROPERTY_TIMEOUT);
 
 			shutter_release();
 			frames--;
@@ -632,28 +1457,108 @@ void action_long_exp() {
 	wait_for_camera();
 
 	if (DPData.ae != AE_MODE_M)
-		send_to_intercom(IC_SET_AE,     AE_MODE_M);
+		set_property_sync(IC_SET_AE,     AE_MODE_M,   PROPERTY_TIMEOUT);
 
 	if (DPData.tv_val != TV_VAL_BULB)
-		send_to_intercom(IC_SET_TV_VAL, TV_VAL_BULB);
+		set_property_sync(IC_SET_TV_VAL, TV_VAL_BULB, PROPERTY_TIMEOUT);
 
 	shutter_release_bulb(settings.lexp_time * TIME_RESOLUTION);
 }
 
-void script_delay(int delay) {
-	while (delay > SCRIPT_DELAY_TIME) {
-		SleepTask(SCRIPT_DELAY_TIME);
+/**
+ * @brief Take a burst of frames in continuous drive
+ *
+ * Each frame is released as soon as the camera has room for it in the buffer,
+ * while the previous ones are still being written to the card; the drive mode
+ * is switched without waiting for the card either, and left for script_restore().
+ * Releases held back by a full buffer are counted in status.burst_stalls,
+ * and the sustained frame rate is left in status.burst_fps; the time they
+ * were held back is waited before the next burst, to let the buffer drain.
+ */
+void action_burst() {
+	int i, poll, first = 0, last = 0;
+	int wait;
+
+	// Stalls waiting for the card are not paid back here: they keep the camera
+	// busy for longer, and the intervalometer stretches the interval for that
+
+	if (DPData.drive != DRIVE_MODE_BURST) {
+		send_to_intercom(IC_SET_CF_MIRROR_UP_LOCK, FALSE);
+		set_property_sync(IC_SET_DRIVE, DRIVE_MODE_BURST, PROPERTY_TIMEOUT);
+	}
 
-		if (!can_continue())
-			return;
+	poll = shutter_set_poll(RELEASE_POLL_FAST);
+
+	for (i = 0; i < settings.burst_frames && can_continue(); i++) {
+		wait = timestamp();
+		wait_for_camera();
+		wait = timestamp() - wait;
+
+		if (i > 0 && wait > BURST_STALL_WAIT) {
+			status.burst_stalls++;
+			trace_event(TRACE_BURST_STALL, i, wait);
+		}
+
+		last = timestamp();
 
-		delay -= SCRIPT_DELAY_TIME;
+		if (i == 0)
+			first = last;
+
+		shutter_release();
+	}
+
+	shutter_set_poll(poll);
+
+	if (i > 1 && last > first) {
+		status.burst_fps = 100 * TIME_RESOLUTION * (i - 1) / (last - first);
+		trace_event(TRACE_BURST_DONE, i, status.burst_fps);
 	}
+}
+
+void script_delay(int delay) {
+	script_sleep(delay);
+}
 
-	if (delay > 0)
+/**
+ * @brief Sleep, but wake up at once if the script is cancelled
+ *
+ * @param delay Time to sleep, in ms
+ * @return TRUE if the whole delay elapsed, FALSE if the script was cancelled
+ */
+int script_sleep(int delay) {
+	int start = timestamp();
+
+	if (delay > 0) {
+		// Pauses are the only time the checkpoint and frame log are written,
+		// see checkpoint.c and telemetry.c
+		checkpoint_idle(delay);
+		telemetry_idle(delay);
+		delay -= timestamp() - start;
+	}
+
+	if (delay <= 0) {
+		return !status.script_stopping;
+	} else if (script_sem == NULL) {
 		SleepTask(delay);
+	} else if (TakeSemaphore(script_sem, delay) == 0) {
+		// Keep the token signalled, so any other wait is cancelled too
+		GiveSemaphore(script_sem);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * @brief Cancel the running script, waking up any wait in progress
+ */
+void script_cancel(void) {
+	status.script_stopping = TRUE;
+
+	if (script_sem != NULL)
+		GiveSemaphore(script_sem);
 }
 
 int can_continue() {
-	return ! (status.script_stopping || DPData.avail_shot < SCRIPT_MIN_SHOTS);
+	return ! (status.script_stopping || DPData.avail_shot < SCRIPT_MIN_SHOTS || monitor_critical);
 }
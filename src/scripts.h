@@ -4,16 +4,37 @@
 // Time between tries while waiting for user
 #define WAIT_USER_ACTION 100
 
+// Fast trigger for handwaving: polling time and task priority while waiting
+#define WAVE_POLL_FAST 2
+#define WAVE_PRIORITY  4
+
+// Pre-armed handwaving: the camera drops a locked-up mirror after this time (ms),
+// our own timing is kept this far (ms) from it on either side
+#define WAVE_MLU_TIMEOUT 30000
+#define WAVE_MLU_MARGIN   1000
+
 // Feedback timing
 #define FEEDBACK_LENGTH    25
 #define FEEDBACK_INTERVAL 500
 
-// Pooling time while delaying script
-#define SCRIPT_DELAY_TIME 250
-
 // Standard delay before starting (2s)
 #define SCRIPT_DELAY_START 2 * TIME_RESOLUTION
 
+// Minimum interval calibration: number of test shots
+#define INTERVAL_CALIBRATION_SHOTS 16
+
+// Largest step the native AEB of the camera can take (+/-2EV)
+#define EAEB_NATIVE_MAX EV_CODE(2, 0)
+
+// Burst action: a release held back longer than this waited for the card (ms)
+#define BURST_STALL_WAIT 200
+
+// Adaptive interval: time kept free after the camera is ready, and granularity
+// of the stretched interval (ms); warn when the card has less than this left (s)
+#define INTERVAL_STRETCH_MARGIN 200
+#define INTERVAL_STRETCH_STEP   250
+#define CARD_WARN_TIME          300
+
 // Minimum number of shots available on card
 #define SCRIPT_MIN_SHOTS 3
 
@@ -24,6 +45,27 @@
 #define BRAMP_MIN_INTERVAL   9
 #define BRAMP_MIN_EXPOSURE 999
 
+// Closed-loop bulb ramping: metering timeout (ms), weight of each new
+// measurement, tolerated deviation and largest correction per frame (EV),
+// and time kept free between the end of an exposure and the next shot (ms)
+#define BRAMP_METER_TIMEOUT 1000
+#define BRAMP_AUTO_WEIGHT   0.3f
+#define BRAMP_AUTO_BAND     0.17f
+#define BRAMP_AUTO_STEP     0.33f
+#define BRAMP_AUTO_MARGIN   2000
+
+#define BRAMP_FILENAME "BRAMP.CSV"
+
+// Closed-loop bulb ramping: one line of the log
+typedef struct {
+	int   frame;     // Frame number
+	int   time;      // Start of the exposure, from the start of the script (ms)
+	int   exposure;  // Exposure time (ms)
+	int   iso;       // ISO code
+	float deviation; // Last measured deviation (EV)
+	float filtered;  // Filtered deviation, after correction (EV)
+} bramp_log_t;
+
 typedef enum {
 	SCRIPT_NONE,
 	SCRIPT_EXT_AEB,
@@ -35,6 +77,8 @@ typedef enum {
 	SCRIPT_WAVE,
 	SCRIPT_TIMER,
 	SCRIPT_LONG_EXP,
+	SCRIPT_TRAILS,
+	SCRIPT_PROGRAM,
 	SCRIPT_COUNT,
 	SCRIPT_FIRST = 0,
 	SCRIPT_LAST  = SCRIPT_COUNT - 1
@@ -45,11 +89,23 @@ extern void script_efl_aeb   (void);
 extern void script_apt_aeb   (void);
 extern void script_iso_aeb   (void);
 extern void script_interval  (void);
+extern void script_interval_calibrate(void);
 extern void script_bramp     (void);
 extern void script_wave      (void);
 extern void script_self_timer(void);
 extern void script_long_exp  (void);
+extern void script_trails    (void);
+extern void script_program   (void);
+extern void script_calibrate (void);
 
 extern void script_restore(void);
+extern void script_resume (void);
+
+extern int  script_action_frames(int action);
+
+extern int  script_sleep  (int delay);
+extern int  can_continue  (void);
+extern void script_battery(int level);
+extern void script_cancel (void);
 
 #endif /* SCRIPTS_H_ */
@@ -9,6 +9,8 @@
 #include "firmware.h"
 
 #include "exposure.h"
+#include "perf.h"
+#include "shutter.h"
 #include "utils.h"
 
 #include "settings.h"
@@ -29,6 +31,7 @@ settings_t settings_default = {
 	.eaeb_tv_min                  = TV_BULB(EV_CODE(15, 0)), // 1/250s
 	.eaeb_tv_max                  = TV_BULB(EV_CODE(13, 0)), // 1/60s
 	.eaeb_direction               = EAEB_DIRECTION_BOTH,
+	.eaeb_native                  = FALSE,
 	.efl_aeb_delay                = FALSE,
 	.efl_aeb_frames               = 3,
 	.efl_aeb_ev                   = EV_CODE( 1, 0), // 1EV
@@ -43,6 +46,10 @@ settings_t settings_default = {
 	.interval_time                = 2,
 	.interval_action              = SHOT_ACTION_SHOT,
 	.interval_shots               = 0,
+	.interval_fast                = FALSE,
+	.interval_ms                  = 800,
+	.interval_low_power           = FALSE,
+	.burst_frames                 = 3,
 	.bramp_delay                  = FALSE,
 	.bramp_time                   = 60,
 	.bramp_shots                  = 100,
@@ -51,12 +58,20 @@ settings_t settings_default = {
 	.bramp_ramp_s                 = 0,
 	.bramp_ramp_exp               = EV_CODE(1, 0),
 	.bramp_ramp_time              = EV_ZERO,
+	.bramp_auto                   = FALSE,
 	.wave_delay                   = FALSE,
 	.wave_action                  = SHOT_ACTION_SHOT,
 	.wave_repeat                  = FALSE,
 	.wave_instant                 = FALSE,
+	.wave_fast                    = FALSE,
+	.wave_prearm                  = FALSE,
 	.lexp_delay                   = FALSE,
 	.lexp_time                    = 60,
+	.trails_delay                 = FALSE,
+	.trails_time                  = 30,
+	.trails_shots                 = 0,
+	.program_delay                = FALSE,
+	.program_slot                 = 1,
 	.remote_delay                 = FALSE,
 	.timer_timeout                = 5,
 	.timer_action                 = SHOT_ACTION_SHOT,
@@ -64,8 +79,17 @@ settings_t settings_default = {
 	.review_off                   = FALSE,
 	.script_lcd                   = SCRIPT_LCD_KEEP,
 	.script_indicator             = SCRIPT_INDICATOR_MEDIUM,
+	.shutter_lag_1st              = SHUTTER_LAG_1ST,
+	.shutter_lag_2nd              = SHUTTER_LAG_2ND,
+	.mirror_lag_1st               = MIRROR_LAG_1ST,
+	.mirror_lag_2nd               = MIRROR_LAG_2ND,
+	.telemetry                    = FALSE,
+	.monitor_temp_max             = 0,
+	.monitor_temp_delay           = 10,
+	.monitor_battery_min          = 0,
 	.debug_on_poweron             = FALSE,
 	.logfile_mode                 = 0,
+	.intercom_record              = FALSE,
 	.remote_enable                = FALSE,
 	.developers_menu              = FALSE,
 	.shortcut_jump                = SHORTCUT_ISO,
@@ -111,7 +135,7 @@ menu_order_t  menu_order;
 named_temps_t named_temps;
 
 int settings_read() {
-	int i;
+	int i, start;
 
 	int result    = FALSE;
 	int file    = -1;
@@ -141,17 +165,23 @@ int settings_read() {
 	menu_order  = menu_order_default;
 	named_temps = named_temps_default;
 
+	start = timestamp();
+
 	if ((file = FIO_OpenFile(MKPATH_NEW(SETTINGS_FILENAME), O_RDONLY)) != -1) {
 		if (read_settings_file(file, &settings) != -1)
 			result   = TRUE;
 		FIO_CloseFile(file);
 	}
+
+	perf_file(PERF_FILE_READ, timestamp() - start);
+
 	return result;
 }
 
 void settings_write() {
 	int file = -1;
 	int success = 1;
+	int start = timestamp();
 
 	if ((file = FIO_OpenFile(MKPATH_NEW(SETTINGS_FILENAME), O_CREAT | O_WRONLY)) != -1) {
 		success = write_settings_file(file, &settings);
@@ -159,6 +189,8 @@ void settings_write() {
 		FIO_CloseFile(file);
 	}
 
+	perf_file(PERF_FILE_WRITE, timestamp() - start);
+
 	if (success == -1) {
 		// Don't want to have a partially written file here, delete it.
         FIO_RemoveFile(MKPATH_NEW(SETTINGS_FILENAME));
@@ -22,6 +22,7 @@ typedef enum {
 	SHOT_ACTION_APT_AEB,
 	SHOT_ACTION_ISO_AEB,
 	SHOT_ACTION_LONG_EXP,
+	SHOT_ACTION_BURST,
 	SHOT_ACTION_COUNT,
 	SHOT_ACTION_FIRST = 0,
 	SHOT_ACTION_LAST  = SHOT_ACTION_COUNT - 1
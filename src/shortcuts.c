@@ -62,6 +62,7 @@
 #include "macros.h"
 
 #include "autoiso.h"
+#include "checkpoint.h"
 #include "display.h"
 #include "persist.h"
 #include "settings.h"
@@ -481,6 +482,12 @@ void dev_btn_action() {
  * @ingroup script_shortcut
  */
 static void repeat_last_script(void) {
+	// An interrupted script takes precedence
+	if (checkpoint_pending()) {
+		script_resume();
+		return;
+	}
+
 	switch (persist.last_script) {
 	case SCRIPT_EXT_AEB:
 		script_ext_aeb();
@@ -500,6 +507,12 @@ static void repeat_last_script(void) {
 	case SCRIPT_TIMER:
 		script_self_timer();
 		break;
+	case SCRIPT_TRAILS:
+		script_trails();
+		break;
+	case SCRIPT_PROGRAM:
+		script_program();
+		break;
 	default:
 		break;
 	}
@@ -11,10 +11,27 @@
 #include "firmware.h"
 #include "firmware/camera.h"
 
+#include "latency.h"
+#include "scripts.h"
+#include "settings.h"
+#include "telemetry.h"
+#include "trace.h"
+
 #include "shutter.h"
 
+int shutter_bulb_error  = 0; // Error in the timing of the last bulb exposure, in ms
+int shutter_bulb_opened = 0; // Timestamp when the last bulb exposure was opened
+int shutter_bulb_closed = 0; // Timestamp when the last bulb exposure was closed
+
+int shutter_ready_time = 0; // Time from the last release until the camera was ready again, in ms
+int shutter_ready_avg  = 0; // Smoothed release-to-ready time, in ms
+
+static int release_poll    = RELEASE_WAIT;
+static int release_pending = 0; // Timestamp of the last release, until the camera is ready again
+
 void lock_sutter     (void);
 void wait_for_shutter(void);
+void shutter_ready   (int time);
 
 void lock_sutter(void) {
 	shutter_lock = TRUE;
@@ -22,61 +39,166 @@ void lock_sutter(void) {
 
 void wait_for_shutter(void) {
 	while (shutter_lock)
-		SleepTask(RELEASE_WAIT);
+		SleepTask(release_poll);
 }
 
+/**
+ * @brief Wait until the camera is able to take another shot
+ *
+ * The time from the last release until the camera is ready again tells how
+ * full the buffer is. When the camera is ready at once, we only know that time
+ * is not longer than the time elapsed, so it is taken only if it is below the average.
+ */
 void wait_for_camera() {
-	while (! able_to_release())
-		SleepTask(RELEASE_WAIT);
+	int waited = FALSE;
+
+	while (! able_to_release()) {
+		SleepTask(release_poll);
+		waited = TRUE;
+	}
+
+	if (release_pending) {
+		int now = timestamp(), elapsed = now - release_pending;
+
+		if (waited || elapsed < shutter_ready_avg)
+			shutter_ready(elapsed);
+
+		latency_ready(now, waited);
+		release_pending = 0;
+	}
+}
+
+void shutter_ready(int time) {
+	shutter_ready_time = time;
+
+	if (shutter_ready_avg == 0)
+		shutter_ready_avg = time;
+	else
+		shutter_ready_avg += (time - shutter_ready_avg) / READY_SMOOTHING;
+}
+
+/**
+ * @brief Forget the release-to-ready times measured so far
+ */
+void shutter_ready_reset() {
+	shutter_ready_time = 0;
+	shutter_ready_avg  = 0;
+	release_pending    = 0;
+}
+
+/**
+ * @brief Set how often we check whether the camera is ready to release
+ *
+ * @param poll Polling time, in ms (RELEASE_WAIT by default)
+ * @return Previous polling time, in ms
+ */
+int shutter_set_poll(int poll) {
+	int previous = release_poll;
+
+	release_poll = poll;
+
+	return previous;
 }
 
 int shutter_release() {
+	int released;
+
 	wait_for_camera();
 	lock_sutter    ();
 
+	trace_event(TRACE_RELEASE, DPData.drive, 0);
+
+	released   = timestamp();
 	int result = press_button(IC_BUTTON_FULL_SHUTTER);
 
+	telemetry_frame(released, FALSE);
+	latency_press  (released);
+
 	if (DPData.drive == DRIVE_MODE_TIMER)
 		SleepTask(SELF_TIMER_MS);
 
 	wait_for_shutter();
+	release_pending = released;
 
 	return result;
 }
 
+/**
+ * @brief Expected time from pressing the shutter button to the start of the exposure
+ *
+ * Based on the lags measured by script_calibrate(); in self-timer drive,
+ * the mirror lag is added to the shutter lag.
+ *
+ * @param first TRUE for the first release of a sequence
+ * @return Lag, in ms
+ */
+int shutter_lag(int first) {
+	int lag = first ? settings.shutter_lag_1st : settings.shutter_lag_2nd;
+
+	if (DPData.drive == DRIVE_MODE_TIMER)
+		lag += first ? settings.mirror_lag_1st : settings.mirror_lag_2nd;
+
+	return lag;
+}
+
+/**
+ * @brief Take a bulb exposure
+ *
+ * The exposure is timed against a deadline, rather than by sleeping for
+ * the whole exposure, so the time spent pressing the button does not add to
+ * it; the sleep still ends on a system tick, so 1 ms is out of reach. The
+ * error is measured from the start and end of the exposure reported by the
+ * camera, and kept in shutter_bulb_error (0 if they were not received).
+ *
+ * @param time Exposure time, in ms
+ */
 int shutter_release_bulb(int time) {
 	static int first = TRUE;
 
 	int  button;
 	long delay;
+	int  deadline, closed;
 
-	int shutter_lag, mirror_lag;
-
-	if (first) {
-		first = FALSE;
-		shutter_lag = SHUTTER_LAG_1ST;
-		mirror_lag  = MIRROR_LAG_1ST;
-	} else {
-		shutter_lag = SHUTTER_LAG_2ND;
-		mirror_lag  = MIRROR_LAG_2ND;
-	}
-
-	if (DPData.drive == DRIVE_MODE_TIMER) {
+	if (DPData.drive == DRIVE_MODE_TIMER)
 		button = IC_BUTTON_FULL_SHUTTER;
-		delay  = time + shutter_lag + mirror_lag;
-	} else {
+	else
 		button = IC_BUTTON_HALF_SHUTTER;
-		delay  = time + shutter_lag;
-	}
+
+	delay = time + shutter_lag(first);
+	first = FALSE;
 
 	wait_for_camera();
 	lock_sutter    ();
 
+	trace_event(TRACE_BULB_OPEN, DPData.drive, delay);
+
+	shutter_bulb_opened = timestamp();
+	deadline = shutter_bulb_opened + delay;
 	press_button(button);
-	SleepTask   (delay);
+
+	telemetry_frame(shutter_bulb_opened, TRUE);
+
+	// A cancelled script closes the shutter at once
+	script_sleep(deadline - timestamp());
+
+	closed = timestamp();
 	press_button(button);
 
+	shutter_bulb_closed = closed;
+
 	wait_for_shutter();
+	release_pending = closed;
+
+	// Our own clock ends the sleep, so it cannot tell its error: ask the camera
+	while (status.last_finish_time < closed && timestamp() - closed < BULB_FINISH_TIMEOUT)
+		SleepTask(EVENT_WAIT);
+
+	if (status.last_shot_time >= shutter_bulb_opened && status.last_finish_time >= closed)
+		shutter_bulb_error = status.last_finish_time - status.last_shot_time - time;
+	else
+		shutter_bulb_error = 0;
+
+	trace_event(TRACE_BULB_CLOSE, 0, shutter_bulb_error);
 
 	return 0;
 }
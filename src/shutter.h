@@ -2,15 +2,34 @@
 #define SHUTTER_H
 
 #define RELEASE_WAIT    250
+#define RELEASE_POLL_FAST 5 // Polling time for back-to-back exposures
 
+// Default lags, until calibrated by script_calibrate() (ms)
 #define SHUTTER_LAG_1ST 250
 #define SHUTTER_LAG_2ND 100
 
 #define MIRROR_LAG_1ST 2000
 #define MIRROR_LAG_2ND 2100
 
-extern void wait_for_camera(void);
+// Lag calibration: number of test releases
+#define LAG_CALIBRATION_SHOTS 5
 
+#define BULB_FINISH_TIMEOUT 250 // Time to wait for the end of a bulb exposure to be reported, in ms
+
+#define READY_SMOOTHING 4 // Weight of the average release-to-ready time against a new sample
+
+extern int shutter_bulb_error;
+extern int shutter_bulb_opened;
+extern int shutter_bulb_closed;
+
+extern int shutter_ready_time;
+extern int shutter_ready_avg;
+
+extern void wait_for_camera (void);
+extern void shutter_ready_reset(void);
+extern int  shutter_set_poll(int poll);
+
+extern int  shutter_lag          (int first);
 extern int  shutter_release      (void);
 extern int  shutter_release_bulb (int time);
 
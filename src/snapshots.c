@@ -12,6 +12,7 @@
 #include "languages.h"
 #include "utils.h"
 #include "intercom.h"
+#include "perf.h"
 
 #include "snapshots.h"
 
@@ -19,6 +20,7 @@ int snapshot_read(char names[][FILENAME_LENGTH], snapshot_t *snapshot) {
 	int result  = FALSE;
 	int file    = -1;
 	int version =  0;
+	int start   = timestamp();
 
 	snapshot_t buffer;
 
@@ -52,6 +54,8 @@ end:
 	if (file != -1)
 		FIO_CloseFile(file);
 
+	perf_file(PERF_FILE_READ, timestamp() - start);
+
 	return result;
 }
 
@@ -60,6 +64,7 @@ int snapshot_write(char names[][FILENAME_LENGTH]) {
 
 	int  result = FALSE;
 	int  file   = -1;
+	int  start  = timestamp();
 
 	snapshot_t buffer = {
 		DPData     : DPData,
@@ -85,6 +90,8 @@ end:
 	if (file != -1)
 		FIO_CloseFile(file);
 
+	perf_file(PERF_FILE_WRITE, timestamp() - start);
+
 	return result;
 }
 
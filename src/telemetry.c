@@ -0,0 +1,185 @@
+/**
+ * \file telemetry.c
+ * \brief Per-frame log of the scripts
+ *
+ * Every release taken while a script runs is recorded, and records are
+ * written to the card during the pauses between frames, once at least
+ * TELEMETRY_FLUSH are waiting, so writing never delays a shot. Only when
+ * the buffer fills up without a long enough pause is it written at once.
+ * Calibration runs (SCRIPT_NONE) are not recorded. A record is completed
+ * with the shoot start / finish times only when the next frame is taken
+ * (or the script stops), as these arrive later from intercom. The file
+ * is decoded on the host with tools/telemetry_tool.pl.
+ */
+
+#include <vxworks.h>
+#include <ioLib.h>
+
+#include "firmware.h"
+#include "firmware/camera.h"
+#include "firmware/fio.h"
+
+#include "main.h"
+#include "macros.h"
+
+#include "perf.h"
+#include "settings.h"
+#include "shutter.h"
+#include "utils.h"
+
+#include "telemetry.h"
+
+static telemetry_record_t telemetry_buffer[TELEMETRY_BLOCK];
+static telemetry_record_t telemetry_pending;
+
+static int telemetry_file    = -1;
+static int telemetry_count   = 0;     // Records in buffer
+static int telemetry_frames  = 0;     // Frames since the script started
+static int telemetry_planned = 0;     // Planned time for the next frame
+static int telemetry_waiting = FALSE; // There is a record pending completion
+
+static void telemetry_commit(void);
+static void telemetry_flush (void);
+
+/**
+ * @brief Start recording the frames of a script
+ *
+ * When resuming a script, records are appended to the existing file, so
+ * the frames taken before the interruption are kept.
+ *
+ * @param script Script being started, one of script_t
+ * @param resume TRUE if the script is resuming from a checkpoint
+ */
+void telemetry_start(int script, int resume) {
+	int size = 0;
+
+	telemetry_header_t header = {
+		magic       : TELEMETRY_MAGIC,
+		version     : TELEMETRY_VERSION,
+		record_size : sizeof(telemetry_record_t),
+		script      : script,
+		start       : timestamp(),
+	};
+
+	telemetry_count   = 0;
+	telemetry_frames  = 0;
+	telemetry_planned = 0;
+	telemetry_waiting = FALSE;
+
+	if (!settings.telemetry || script == SCRIPT_NONE)
+		return;
+
+	if (resume)
+		FIO_GetFileSize(MKPATH_NEW(TELEMETRY_FILENAME), &size);
+
+	if (size < (int)sizeof(header))
+		FIO_RemoveFile(MKPATH_NEW(TELEMETRY_FILENAME));
+
+	if ((telemetry_file = FIO_OpenFile(MKPATH_NEW(TELEMETRY_FILENAME), O_CREAT | O_WRONLY)) == -1)
+		return;
+
+	if (size < (int)sizeof(header)) {
+		FIO_WriteFile(telemetry_file, &header, sizeof(header));
+	} else {
+		// Keep numbering the frames after those already in the file
+		telemetry_frames = (size - sizeof(header)) / sizeof(telemetry_record_t);
+		FIO_SeekFile(telemetry_file, 0, SEEK_END);
+	}
+}
+
+/**
+ * @brief Write all pending records, and close the file
+ */
+void telemetry_stop() {
+	if (telemetry_file == -1)
+		return;
+
+	if (telemetry_waiting)
+		telemetry_commit();
+
+	telemetry_flush();
+
+	FIO_CloseFile(telemetry_file);
+	telemetry_file = -1;
+}
+
+/**
+ * @brief Write pending records, if the script is about to wait long enough
+ *
+ * Called at the start of every pause of a script.
+ *
+ * @param delay Length of the pause, in ms
+ */
+void telemetry_idle(int delay) {
+	if (telemetry_file != -1 && telemetry_count >= TELEMETRY_FLUSH && delay >= TELEMETRY_IDLE_MIN)
+		telemetry_flush();
+}
+
+/**
+ * @brief Tell when the next release is supposed to happen
+ *
+ * @param time Timestamp of the planned release
+ */
+void telemetry_plan(int time) {
+	telemetry_planned = time;
+}
+
+/**
+ * @brief Record a release
+ *
+ * Must be called right after pressing the shutter button.
+ *
+ * @param released Timestamp when the button was pressed
+ * @param bulb     TRUE for bulb exposures
+ */
+void telemetry_frame(int released, int bulb) {
+	if (telemetry_file == -1)
+		return;
+
+	if (telemetry_waiting)
+		telemetry_commit();
+
+	telemetry_pending.planned    = telemetry_planned ? telemetry_planned : released;
+	telemetry_pending.released   = released;
+	telemetry_pending.frame      = telemetry_frames++;
+	telemetry_pending.avail_shot = DPData.avail_shot;
+	telemetry_pending.tv         = DPData.tv_val;
+	telemetry_pending.av         = DPData.av_val;
+	telemetry_pending.iso        = DPData.iso;
+	telemetry_pending.efcomp     = DPData.efcomp;
+	telemetry_pending.battery    = DPData.batt_bclevel;
+	telemetry_pending.bulb       = bulb;
+
+	telemetry_pending.temperature  = status.temperature;
+	telemetry_pending.battery_type = status.battery_type;
+
+	telemetry_planned = 0;
+	telemetry_waiting = TRUE;
+}
+
+static void telemetry_commit() {
+	telemetry_record_t *record = &telemetry_buffer[telemetry_count++];
+
+	*record = telemetry_pending;
+
+	record->started    = status.last_shot_time   >= record->released ? status.last_shot_time   : 0;
+	record->finished   = status.last_finish_time >= record->released ? status.last_finish_time : 0;
+	record->bulb_error = record->bulb ? shutter_bulb_error : 0;
+
+	telemetry_waiting = FALSE;
+
+	// No pause was long enough to write the records, do not lose them
+	if (telemetry_count == TELEMETRY_BLOCK)
+		telemetry_flush();
+}
+
+static void telemetry_flush() {
+	if (telemetry_count > 0) {
+		int start = timestamp();
+
+		FIO_WriteFile(telemetry_file, telemetry_buffer, telemetry_count * sizeof(telemetry_record_t));
+		perf_file(PERF_FILE_WRITE, timestamp() - start);
+	}
+
+	telemetry_count = 0;
+}
@@ -0,0 +1,50 @@
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/**
+ * \file telemetry.h
+ * \brief Header for telemetry.c
+ */
+
+#define TELEMETRY_FILENAME "FRAMES.BIN"
+#define TELEMETRY_MAGIC    0x4D52464C // "LFRM"
+#define TELEMETRY_VERSION  0x02
+
+#define TELEMETRY_BLOCK    64 // Records kept in memory
+#define TELEMETRY_FLUSH    16 // Records waiting before they are written during a pause
+#define TELEMETRY_IDLE_MIN 500 // Shortest pause to write records in, in ms
+
+typedef struct {
+	int            planned;    // Timestamp when the release was planned, or 0
+	int            released;   // Timestamp when the shutter button was pressed
+	int            started;    // Timestamp of IC_SHOOT_START, or 0 if not received
+	int            finished;   // Timestamp of IC_SHOOT_FINISH, or 0 if not received
+	unsigned short frame;      // Frame number, from the start of the script
+	unsigned short avail_shot; // Shots available on card
+	unsigned char  tv;         // Shutter speed (TV_VAL_BULB for bulb)
+	unsigned char  av;         // Aperture
+	unsigned char  iso;        // ISO
+	signed char    efcomp;     // Flash exposure compensation
+	unsigned char  battery;    // Battery level, as reported by the camera
+	unsigned char  bulb;       // TRUE for bulb exposures
+	short          bulb_error; // Error in the timing of bulb exposures, in ms
+	unsigned char  temperature;  // Temperature, as last reported by the camera
+	unsigned char  battery_type; // Battery type, as last reported by the camera
+	short          reserved;
+} telemetry_record_t;
+
+typedef struct {
+	int magic;
+	int version;
+	int record_size;
+	int script;    // Script that took the frames, one of script_t
+	int start;     // Timestamp when the script started
+} telemetry_header_t;
+
+extern void telemetry_start(int script, int resume);
+extern void telemetry_stop (void);
+extern void telemetry_idle (int delay);
+extern void telemetry_plan (int time);
+extern void telemetry_frame(int released, int bulb);
+
+#endif /* TELEMETRY_H_ */
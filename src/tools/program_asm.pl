@@ -0,0 +1,187 @@
+#!/usr/bin/perl
+#
+# Assemble a user program for the camera (A:/420D/PROGn.BIN, see program.c)
+#
+# One instruction per line; "#" starts a comment, and "name:" defines a label.
+#
+#   ae m|av|tv|p          AE mode
+#   tv 1/125|2"|30s|bulb  shutter speed
+#   av 5.6                aperture
+#   iso 400               ISO
+#   ef -1/3               flash exposure compensation (EV)
+#   release               take a shot
+#   bulb 30s              bulb exposure (shutter speed must be "bulb")
+#   wait 500ms            wait
+#   until 2m              wait until this time after the start of the program
+#   loop 10 ... next      repeat (loop 0 repeats for ever)
+#   measure               measure the scene (deviation is only reported in M mode)
+#   if ev < -1 label      jump if the measured deviation is below / above the value (EV)
+#   goto label            jump
+#   end                   stop
+#
+# Times take an optional unit (ms, s, m, h), and default to ms.
+#
+# Usage: program_asm.pl SOURCE.TXT PROG1.BIN
+
+use strict;
+use POSIX qw(floor);
+
+my %opcodes = (
+	end => 0, ae => 1, tv => 2, av => 3, iso => 4, ef => 5, release => 6, bulb => 7,
+	wait => 8, until => 9, loop => 10, next => 11, measure => 12, iflt => 13, ifgt => 14, goto => 15,
+);
+
+my %ae_modes = (p => 0x00, tv => 0x01, av => 0x02, m => 0x03);
+
+my $max_size = 256;
+
+@ARGV == 2 || die "usage: $0 SOURCE.TXT PROG1.BIN\n";
+
+# parse source {{{
+my (@code, %labels, @fixups);
+
+open (SF, $ARGV[0]) || die "cannot open the source file [$ARGV[0]]\n";
+while (<SF>) {
+	s/#.*//;
+	next unless /\S/;
+
+	while (s/^\s*(\w+)\s*://) {
+		die "line $.: label [$1] defined twice\n" if exists $labels{$1};
+		$labels{$1} = scalar @code;
+	}
+
+	next unless /\S/;
+
+	my ($op, @args) = split;
+	my ($value, $target) = (0, undef);
+
+	$op = lc $op;
+
+	if ($op eq 'if') {
+		@args == 4 && lc $args[0] eq 'ev' || die "line $.: expected [if ev < value label]\n";
+		$op     = $args[1] eq '<' ? 'iflt' : $args[1] eq '>' ? 'ifgt' : die "line $.: unknown comparison [$args[1]]\n";
+		$value  = ec ($args[2]);
+		$target = $args[3];
+	} elsif ($op eq 'goto') {
+		$target = $args[0];
+	} elsif ($op eq 'ae') {
+		$value = $ae_modes{lc $args[0]} // die "line $.: unknown AE mode [$args[0]]\n";
+	} elsif ($op eq 'tv') {
+		$value = tv ($args[0]);
+	} elsif ($op eq 'av') {
+		$value = av ($args[0]);
+	} elsif ($op eq 'iso') {
+		$value = iso ($args[0]);
+	} elsif ($op eq 'ef') {
+		$value = ec ($args[0]);
+	} elsif ($op =~ /^(bulb|wait|until)$/) {
+		$value = ms ($args[0]);
+	} elsif ($op eq 'loop') {
+		$value = $args[0] // 0;
+	}
+
+	exists $opcodes{$op} || die "line $.: unknown instruction [$op]\n";
+
+	push @fixups, [scalar @code, $target, $.] if defined $target;
+	push @code, [$opcodes{$op}, 0, $value];
+}
+close (SF);
+
+@code > 0         || die "empty program\n";
+@code <= $max_size || die "program too long, " . scalar @code . " instructions (maximum $max_size)\n";
+
+foreach my $fixup (@fixups) {
+	my ($index, $label, $line) = @$fixup;
+
+	exists $labels{$label} || die "line $line: unknown label [$label]\n";
+	$code[$index][1] = $labels{$label};
+}
+#}}}
+
+# write program {{{
+open (PF, ">$ARGV[1]") || die "cannot create the program file [$ARGV[1]]\n";
+binmode PF;
+
+print PF pack ("V3", 0x474F5250, 1, scalar @code);
+print PF pack ("C C v l<", $_->[0], 0, $_->[1], $_->[2]) foreach @code;
+
+close (PF);
+#}}}
+
+# Values are encoded as the camera does, in 1/8 EV steps {{{
+sub log2 {
+	return log (shift) / log (2);
+}
+
+# Round to the nearest 1/3 or 1/2 EV step, as nominal values are not exact powers of two
+sub snap {
+	my $value = shift;
+	my $whole = 8 * floor ($value / 8);
+	my $best  = 0;
+
+	foreach my $step (3, 4, 5, 8) {
+		$best = $step if abs ($value - $whole - $step) < abs ($value - $whole - $best);
+	}
+
+	return $whole + $best;
+}
+
+sub ms {
+	my $time = shift;
+
+	$time =~ /^(\d+(?:\.\d+)?)(ms|s|m|h)?$/ || die "line $.: invalid time [$time]\n";
+
+	my %units = ('' => 1, ms => 1, s => 1000, m => 60000, h => 3600000);
+
+	return int ($1 * $units{$2 // ''} + 0.5);
+}
+
+sub ec {
+	my $ev = shift;
+
+	$ev =~ /^([+-]?)(\d+)(?:\/(\d+))?$|^([+-]?\d*\.\d+)$/ || die "line $.: invalid EV [$ev]\n";
+
+	my $value = defined $4 ? $4 : ($1 eq '-' ? -1 : 1) * $2 / ($3 // 1);
+
+	return int ($value * 8 + ($value < 0 ? -0.5 : 0.5));
+}
+
+sub tv {
+	my $tv = lc shift;
+
+	return 0x0C      if $tv eq 'bulb';
+	return hex ($tv) if $tv =~ /^0x/;
+
+	my $time;
+
+	if ($tv =~ /^1\/(\d+(?:\.\d+)?)$/) {
+		$time = 1 / $1;
+	} elsif ($tv =~ /^(\d+(?:\.\d+)?)(?:"|s)?$/) {
+		$time = $1;
+	} else {
+		die "line $.: invalid shutter speed [$tv]\n";
+	}
+
+	return 0x38 + snap (8 * log2 (1 / $time));
+}
+
+sub av {
+	my $av = lc shift;
+
+	return hex ($av) if $av =~ /^0x/;
+
+	$av =~ /^f?\/?(\d+(?:\.\d+)?)$/ || die "line $.: invalid aperture [$av]\n";
+
+	return 0x08 + snap (16 * log2 ($1));
+}
+
+sub iso {
+	my $iso = lc shift;
+
+	return hex ($iso) if $iso =~ /^0x/;
+
+	$iso =~ /^\d+$/ || die "line $.: invalid ISO [$iso]\n";
+
+	return 0x48 + int (8 * log2 ($iso / 100) + 0.5);
+}
+#}}}
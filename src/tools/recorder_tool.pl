@@ -0,0 +1,123 @@
+#!/usr/bin/perl
+#
+# Decode and replay an intercom capture dumped by the camera
+# (A:/420D/INTERCOM.BIN)
+#
+# Message names are taken from firmware.h; in replay mode, the listener
+# tables and proxies in intercom.c are used to dispatch every frame as
+# intercom_proxy would, and a per-table and per-proxy load report is printed.
+#
+# Usage: recorder_tool.pl [--src ..] [--csv | --replay] INTERCOM.BIN
+
+use strict;
+use Getopt::Long;
+
+my $src_dir = ".";
+my $csv     = 0;
+my $replay  = 0;
+
+GetOptions (
+	'src|s=s'  => \$src_dir,
+	'csv|c'    => \$csv,
+	'replay|r' => \$replay,
+) && @ARGV == 1 || die "usage: $0 [--src dir] [--csv | --replay] INTERCOM.BIN\n";
+
+my @states = ('main', 'menu', 'script');
+
+# parse message names {{{
+my %names;
+open (FH, "$src_dir/firmware.h") || die "cannot open [$src_dir/firmware.h]\n";
+while (<FH>) {
+	$names{hex($2)} = $1 if /^\s*(IC_\w+)\s*=\s*(0x[0-9A-Fa-f]+)/;
+}
+close (FH);
+
+my %ids = reverse %names;
+#}}}
+
+# parse listener tables and proxies {{{
+my (%listeners, %enqueues);
+if ($replay) {
+	my ($table, $proxy);
+	open (IH, "$src_dir/intercom.c") || die "cannot open [$src_dir/intercom.c]\n";
+	while (<IH>) {
+		if (/^\S.*\b(\w+)_listeners\s*\[/) {
+			$table = $1;
+		} elsif ($table && /^\s*\{\s*(IC_\w+)\s*,\s*(\w+)\s*\}/) {
+			$listeners{$table}{$ids{$1}} = $2;
+		} elsif (/^};/) {
+			$table = undef;
+		}
+
+		if (/^int\s+(proxy_\w+)\s*\(.*\)\s*\{/) {
+			$proxy = $1;
+		} elsif ($proxy && /enqueue_action\s*\(/) {
+			$enqueues{$proxy}++;
+		} elsif (/^}/) {
+			$proxy = undef;
+		}
+	}
+	close (IH);
+}
+#}}}
+
+# read capture {{{
+my $buffer;
+open (CF, $ARGV[0]) || die "cannot open the capture file [$ARGV[0]]\n";
+binmode CF;
+
+read (CF, $buffer, 20) == 20 || die "capture file too short\n";
+my ($magic, $version, $frame_size, $count, $lost) = unpack ("V5", $buffer);
+
+die "not an intercom capture\n"              unless $magic == 0x43525449;
+die "unsupported capture version $version\n" unless $version == 1;
+
+my (%per_state, %per_proxy, $first, $last, $frames, $actions);
+
+print "timestamp,handler,state,length,id,name,data\n" if $csv;
+printf ("# %d frames, %d lost\n", $count, $lost) unless $csv || $replay;
+
+while ($count-- > 0 && read (CF, $buffer, $frame_size) == $frame_size) {
+	my ($timestamp, $handler, $state, @frame) = unpack ("l< C C C*", $buffer);
+	my $length = $frame[0];
+	my $id     = $frame[1];
+	my $name   = $names{$id} || sprintf ("IC_0x%02X", $id);
+	my $data   = join (" ", map { sprintf ("%02X", $_) } @frame[2 .. ($length < @frame ? $length : @frame) - 1]);
+
+	$first = $timestamp unless defined $first;
+	$last  = $timestamp;
+	$frames++;
+
+	if ($replay) {
+		my $table = $states[$state];
+		my $proxy = $listeners{$table}{$id};
+
+		$per_state{$table}++;
+
+		if ($proxy) {
+			$per_proxy{$proxy}++;
+			$actions += $enqueues{$proxy} || 0;
+		}
+	} elsif ($csv) {
+		printf ("%d,%d,%s,%d,%d,%s,%s\n", $timestamp, $handler, $states[$state], $length, $id, $name, $data);
+	} else {
+		printf ("%6d.%03d %-6s %-26s %s\n", $timestamp / 1000, $timestamp % 1000, $states[$state], $name, $data);
+	}
+}
+close (CF);
+#}}}
+
+# replay report {{{
+if ($replay && $frames) {
+	my $seconds = ($last - $first) / 1000 || 1;
+
+	printf ("frames:   %d in %.3f s (%.1f msg/s)\n", $frames, $seconds, $frames / $seconds);
+	printf ("actions:  at most %d enqueued (%.1f/s)\n", $actions, $actions / $seconds);
+
+	print "\ntable     frames\n";
+	printf ("%-8s %7d\n", $_, $per_state{$_}) foreach (grep { $per_state{$_} } @states);
+
+	print "\nproxy                  calls\n";
+	printf ("%-20s %7d\n", $_, $per_proxy{$_}) foreach (sort { $per_proxy{$b} <=> $per_proxy{$a} } keys %per_proxy);
+}
+#}}}
@@ -0,0 +1,54 @@
+#!/usr/bin/perl
+#
+# Convert the per-frame log written by the scripts (A:/420D/FRAMES.BIN) to CSV
+#
+# Times are in ms; "delay" is how late the release was with respect to the
+# planned time, and "gap" the time since the previous release.
+#
+# Usage: telemetry_tool.pl FRAMES.BIN
+
+use strict;
+
+@ARGV == 1 || die "usage: $0 FRAMES.BIN\n";
+
+# read log {{{
+my $buffer;
+open (TF, $ARGV[0]) || die "cannot open the log file [$ARGV[0]]\n";
+binmode TF;
+
+read (TF, $buffer, 20) == 20 || die "log file too short\n";
+my ($magic, $version, $record_size, $script, $start) = unpack ("V3 l< l<", $buffer);
+
+die "not a frame log\n"                  unless $magic == 0x4D52464C;
+die "unsupported log version $version\n" unless $version == 1 || $version == 2;
+
+printf ("# script %d, started at %d ms\n", $script, $start);
+print "frame,planned,released,delay,gap,started,finished,tv,av,iso,efcomp,bulb,bulb_error,avail_shot,battery,temperature,battery_type\n";
+
+my $previous;
+
+while (read (TF, $buffer, $record_size) == $record_size) {
+	# Version 1 records end after bulb_error, without temperature nor battery type
+	my ($planned, $released, $started, $finished, $frame, $avail, $tv, $av, $iso, $efcomp, $battery, $bulb, $error, $temperature, $type) =
+		unpack ("l< l< l< l< v v C C C c C C s< C C", $buffer);
+
+	my $gap = defined $previous ? $released - $previous : 0;
+	$previous = $released;
+
+	printf ("%d,%d,%d,%d,%d,%s,%s,0x%02X,0x%02X,%d,%d,%d,%d,%d,%d,%s,%s\n",
+		$frame, $planned - $start, $released - $start, $released - $planned, $gap,
+		$started  ? $started  - $start : "",
+		$finished ? $finished - $start : "",
+		$tv, $av, iso ($iso), $efcomp, $bulb, $error, $avail, $battery,
+		$version > 1 ? $temperature : "", $version > 1 ? $type : "");
+}
+close (TF);
+#}}}
+
+# ISO codes are 1/8 EV steps, with ISO 100 at 9EV
+sub iso {
+	my $code = shift;
+	my $iso  = 100 * (1 << (($code >> 3) - 9));
+
+	return $iso + $iso * ($code & 7) / 8;
+}
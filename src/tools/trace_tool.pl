@@ -0,0 +1,60 @@
+#!/usr/bin/perl
+#
+# Decode a binary trace dumped by the camera (A:/420D/TRACE.BIN)
+#
+# Event names and formats are taken from trace.def, so the tool must be run
+# against the same sources that were used to build the firmware.
+#
+# Usage: trace_tool.pl [--def ../trace.def] [--csv] TRACE.BIN
+
+use strict;
+use Getopt::Long;
+
+my $def_file = "trace.def";
+my $csv      = 0;
+
+GetOptions (
+	'def|d=s' => \$def_file,
+	'csv|c'   => \$csv,
+) && @ARGV == 1 || die "usage: $0 [--def trace.def] [--csv] TRACE.BIN\n";
+
+# parse event list {{{
+my @events;
+open (DF, $def_file) || die "cannot open the definition file [$def_file]\n";
+while (<DF>) {
+	next unless /^\s*TRACE_EVENT_DEF\s*\(\s*(\w+)\s*,\s*"(.*)"\s*\)/;
+	push @events, { name => $1, format => $2 };
+}
+close (DF);
+#}}}
+
+# read trace {{{
+my $buffer;
+open (TF, $ARGV[0]) || die "cannot open the trace file [$ARGV[0]]\n";
+binmode TF;
+
+read (TF, $buffer, 20) == 20 || die "trace file too short\n";
+my ($magic, $version, $record_size, $count, $lost) = unpack ("V5", $buffer);
+
+die "not a trace file\n"                   unless $magic == 0x45435254;
+die "unsupported trace version $version\n" unless $version == 1;
+
+if ($csv) {
+	print "timestamp,event,arg1,arg2\n";
+} else {
+	printf ("# %d records, %d lost\n", $count, $lost);
+}
+
+while ($count-- > 0 && read (TF, $buffer, $record_size) == $record_size) {
+	my ($timestamp, $event, $arg1, $arg2) = unpack ("l< v s< l<", $buffer);
+	my $name   = $event < @events ? $events[$event]->{name}   : sprintf ("EVENT_%d", $event);
+	my $format = $event < @events ? $events[$event]->{format} : "%d %d";
+
+	if ($csv) {
+		printf ("%d,%s,%d,%d\n", $timestamp, $name, $arg1, $arg2);
+	} else {
+		printf ("%6d.%03d %-20s %s\n", $timestamp / 1000, $timestamp % 1000, $name, sprintf ($format, $arg1, $arg2));
+	}
+}
+close (TF);
+#}}}
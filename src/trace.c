@@ -0,0 +1,78 @@
+/**
+ * \file trace.c
+ * \brief Compact binary event trace
+ *
+ * Events are stored as fixed-size records in a ring buffer in memory, so
+ * tracing is cheap enough to be left running; the buffer can be dumped to
+ * a file on demand and decoded on the host with tools/trace_tool.pl.
+ */
+
+#include <vxworks.h>
+#include <intLib.h>
+#include <ioLib.h>
+
+#include "firmware.h"
+#include "firmware/fio.h"
+
+#include "main.h"
+
+#include "utils.h"
+
+#include "trace.h"
+
+static trace_record_t trace_buffer[TRACE_SIZE];
+static int            trace_total = 0;
+
+/**
+ * @brief Append an event to the trace
+ *
+ * @param event Event identifier, as listed in trace.def
+ * @param arg1  First argument (truncated to 16 bits)
+ * @param arg2  Second argument
+ */
+void trace_event(trace_event_t event, int arg1, int arg2) {
+	int now = timestamp();
+	int key = intLock();
+
+	trace_record_t *record = &trace_buffer[trace_total++ % TRACE_SIZE];
+
+	record->timestamp = now;
+	record->event     = event;
+	record->arg1      = arg1;
+	record->arg2      = arg2;
+
+	intUnlock(key);
+}
+
+/**
+ * @brief Write the trace to a file, oldest record first
+ */
+void trace_dump(void) {
+	int file  = -1;
+	int total = trace_total;
+	int first = total > TRACE_SIZE ? total % TRACE_SIZE : 0;
+
+	trace_header_t header = {
+		magic       : TRACE_MAGIC,
+		version     : TRACE_VERSION,
+		record_size : sizeof(trace_record_t),
+		count       : total > TRACE_SIZE ? TRACE_SIZE : total,
+		lost        : total > TRACE_SIZE ? total - TRACE_SIZE : 0,
+	};
+
+	if ((file = FIO_OpenFile(MKPATH_NEW(TRACE_FILENAME), O_CREAT | O_WRONLY)) == -1)
+		goto end;
+
+	FIO_WriteFile(file, &header, sizeof(header));
+
+	if (first)
+		FIO_WriteFile(file, &trace_buffer[first], (TRACE_SIZE - first) * sizeof(trace_record_t));
+
+	FIO_WriteFile(file, &trace_buffer[0], (header.count - (first ? TRACE_SIZE - first : 0)) * sizeof(trace_record_t));
+
+end:
+	if (file != -1)
+		FIO_CloseFile(file);
+
+	beep();
+}
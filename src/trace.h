@@ -0,0 +1,42 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/**
+ * \file trace.h
+ * \brief Header for trace.c
+ */
+
+#define TRACE_FILENAME "TRACE.BIN"
+#define TRACE_MAGIC    0x45435254 // "TRCE"
+#define TRACE_VERSION  0x01
+
+#define TRACE_SIZE     256 // Records kept in memory
+
+#define TRACE_EVENT_DEF(name, format) name,
+typedef enum {
+	#include "trace.def"
+	TRACE_COUNT,
+	TRACE_FIRST = 0,
+	TRACE_LAST  = TRACE_COUNT - 1
+} trace_event_t;
+#undef TRACE_EVENT_DEF
+
+typedef struct {
+	int            timestamp; // Milliseconds since start-up
+	unsigned short event;     // One of trace_event_t
+	short          arg1;
+	int            arg2;
+} trace_record_t;
+
+typedef struct {
+	int magic;
+	int version;
+	int record_size;
+	int count;     // Records following this header
+	int lost;      // Records overwritten before this dump
+} trace_header_t;
+
+extern void trace_event(trace_event_t event, int arg1, int arg2);
+extern void trace_dump (void);
+
+#endif /* TRACE_H_ */
@@ -61,7 +61,9 @@
 
 #include "viewfinder.h"
 
-dpr_data_t vf_DPData;
+// State changed to display the ISO, restored by viewfinder_end
+static int vf_tv_val;
+static int vf_emit_aux;
 
 void viewfinder_change_iso (iso_t iso);
 void viewfinder_display_iso(iso_t iso);
@@ -165,11 +167,11 @@ void viewfinder_end() {
 		case AE_MODE_M:
 		case AE_MODE_TV:
 			// Restore previous state
-			send_to_intercom(IC_SET_CF_EMIT_FLASH, vf_DPData.cf_emit_aux);
-			send_to_intercom(IC_SET_TV_VAL,        vf_DPData.tv_val);
+			send_to_intercom(IC_SET_CF_EMIT_FLASH, vf_emit_aux);
+			send_to_intercom(IC_SET_TV_VAL,        vf_tv_val);
 
 			// Do not reset VF_STATUS if Tv was not restored
-			if (DPData.tv_val != vf_DPData.tv_val)
+			if (DPData.tv_val != vf_tv_val)
 				return;
 
 			break;
@@ -208,7 +210,8 @@ void viewfinder_change_iso(iso_t iso) {
 
 void viewfinder_display_iso(iso_t iso) {
 	// Save current state
-	vf_DPData = DPData;
+	vf_tv_val   = DPData.tv_val;
+	vf_emit_aux = DPData.cf_emit_aux;
 
 	switch (DPData.ae) {
 	// Display ISO as shutter speed